@@ -2,14 +2,22 @@
 # FFTW3F_FOUND = true if fftw3f is found
 # FFTW3F_INCLUDE_DIR = fftw3.h
 # FFTW3F_LIBRARIES = libfftw3f.a .so
+# FFTW3F_THREADS_FOUND = true if also fftw3f_threads is found, it is then
+# part of FFTW3F_LIBRARIES
 
 find_path(FFTW3F_INCLUDE_DIR fftw3.h)
 find_library(FFTW3F_LIBRARIES fftw3f)
+find_library(FFTW3F_THREADS_LIBRARY fftw3f_threads)
 
 set(FFTW3F_FOUND FALSE)
 if(FFTW3F_INCLUDE_DIR AND FFTW3F_LIBRARIES)
     set(FFTW3F_FOUND TRUE)
     MESSAGE(STATUS "FFTW3 with single precision (FFTW3F): Found!")
+    if(FFTW3F_THREADS_LIBRARY)
+        set(FFTW3F_THREADS_FOUND TRUE)
+        set(FFTW3F_LIBRARIES ${FFTW3F_THREADS_LIBRARY} ${FFTW3F_LIBRARIES})
+        MESSAGE(STATUS "  Threads:     ${FFTW3F_THREADS_LIBRARY}")
+    endif()
 else()
     MESSAGE(STATUS "FFTW3 with single precision (FFTW3F): NOT Found!")
 endif()
@@ -17,4 +25,5 @@ endif()
 MESSAGE(STATUS "  Include:     ${FFTW3F_INCLUDE_DIR}")
 MESSAGE(STATUS "  Library:     ${FFTW3F_LIBRARIES}")
 
-mark_as_advanced(FFTW3F_INCLUDE_DIR FFTW3F_LIBRARIES FFTW3F_FOUND)
+mark_as_advanced(FFTW3F_INCLUDE_DIR FFTW3F_LIBRARIES FFTW3F_FOUND
+                 FFTW3F_THREADS_LIBRARY)
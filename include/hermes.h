@@ -1,12 +1,15 @@
 #ifndef HERMES_H
 #define HERMES_H
 
+#include "hermes/BakedGrid.h"
 #include "hermes/CacheTools.h"
 #include "hermes/Common.h"
 #include "hermes/FITSWrapper.h"
 #include "hermes/Grid.h"
 #include "hermes/GridTools.h"
 #include "hermes/HEALPixBits.h"
+#include "hermes/MappedStorage.h"
+#include "hermes/SpectralGrid.h"
 #include "hermes/ParticleID.h"
 #include "hermes/ProgressBar.h"
 #include "hermes/Random.h"
@@ -16,6 +19,7 @@
 #include "hermes/Vector3Quantity.h"
 #include "hermes/Version.h"
 #include "hermes/chargedgas/ChargedGasDensity.h"
+#include "hermes/chargedgas/ChargedGasDensityGrid.h"
 #include "hermes/chargedgas/HII_Cordes91.h"
 #include "hermes/chargedgas/NE2001Simple.h"
 #include "hermes/chargedgas/YMW16.h"
@@ -40,8 +44,10 @@
 #include "hermes/integrators/PiZeroAbsorptionIntegrator.h"
 #include "hermes/integrators/PiZeroIntegrator.h"
 #include "hermes/integrators/RotationMeasureIntegrator.h"
+#include "hermes/integrators/RotationMeasureIntegratorT.h"
 #include "hermes/integrators/SynchroAbsorptionIntegrator.h"
 #include "hermes/integrators/SynchroIntegrator.h"
+#include "hermes/integrators/SynchroIntegratorT.h"
 #include "hermes/interactions/BreitWheeler.h"
 #include "hermes/interactions/BremsstrahlungAbstract.h"
 #include "hermes/interactions/BremsstrahlungGALPROP.h"
@@ -53,15 +59,18 @@
 #include "hermes/interactions/KelnerAharonianGamma.h"
 #include "hermes/interactions/KelnerAharonianNeutrino.h"
 #include "hermes/interactions/KleinNishina.h"
+#include "hermes/magneticfields/BakedMagneticField.h"
 #include "hermes/magneticfields/JF12.h"
 #include "hermes/magneticfields/MagneticField.h"
 #include "hermes/magneticfields/MagneticFieldGrid.h"
 #include "hermes/magneticfields/PT11Field.h"
+#include "hermes/magneticfields/PlaneWaveTurbulence.h"
 #include "hermes/magneticfields/Sun08Field.h"
 #include "hermes/magneticfields/WMAP07Field.h"
 #include "hermes/neutralgas/GasType.h"
 #include "hermes/neutralgas/NeutralGasAbstract.h"
 #include "hermes/neutralgas/ProfileAbstract.h"
+#include "hermes/neutralgas/ProfileGrid.h"
 #include "hermes/neutralgas/RingModel.h"
 #include "hermes/outputs/CTAFormat.h"
 #include "hermes/outputs/HEALPixFormat.h"
@@ -0,0 +1,96 @@
+#ifndef HERMES_BAKEDGRID_H
+#define HERMES_BAKEDGRID_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "hermes/Grid.h"
+#include "hermes/Units.h"
+#include "hermes/Vector3Quantity.h"
+
+namespace hermes {
+/**
+ * \addtogroup Core
+ * @{
+ */
+
+/**
+ @class BakedGrid
+ @brief ScalarGrid holding samples of an analytic model, with an optional
+ non-uniform z axis
+
+ The x and y axes are uniform. The z axis is either uniform as well or given
+ by an increasing list of z planes, which allows a fine sampling close to the
+ Galactic plane and a coarse one in the halo. The grid is only used between
+ the first and the last grid planes of each axis (isInside()); values are in
+ SI units and can be written and read back with dumpGrid()/loadGrid() on
+ getGrid() of a BakedGrid with the same geometry.
+ */
+class BakedGrid {
+  public:
+	/** Evaluates a model at all positions at once, values is resized to
+	 * positions.size(); this is how the batch APIs of the models are used */
+	typedef std::function<void(const std::vector<Vector3QLength> &positions,
+	                           std::vector<double> &values)>
+	    BatchFunction;
+
+  private:
+	std::shared_ptr<ScalarGrid> grid;
+	std::vector<double> zAxis; /**< z of the grid planes (m), empty if the z
+	                              axis is uniform */
+	Vector3d lower, upper;     /**< First and last grid planes */
+
+	/** Coordinate of the underlying grid along z */
+	double gridZ(double z) const;
+
+  public:
+	/** Uniform grid
+	 @param	origin	Position of the lower left front corner of the volume
+	 @param	Nx		Number of grid points in x-direction
+	 @param	Ny		Number of grid points in y-direction
+	 @param	Nz		Number of grid points in z-direction
+	 @param spacing	Spacing vector between grid points
+	 */
+	BakedGrid(const Vector3QLength &origin, size_t Nx, size_t Ny, size_t Nz,
+	          const Vector3QLength &spacing);
+	/** Grid with uniform x and y axes and given z planes
+	 @param	origin	Lower left corner of the volume, z is not used
+	 @param	Nx		Number of grid points in x-direction
+	 @param	Ny		Number of grid points in y-direction
+	 @param spacing	Spacing between grid points, z is not used
+	 @param	zAxis	Increasing z positions of the grid planes
+	 */
+	BakedGrid(const Vector3QLength &origin, size_t Nx, size_t Ny,
+	          const Vector3QLength &spacing, const std::vector<QLength> &zAxis);
+	/** Copies have their own values */
+	BakedGrid(const BakedGrid &other);
+	BakedGrid &operator=(const BakedGrid &other);
+
+	/** Sample f at all grid points; the z columns are distributed over
+	 * getThreadsNumber() threads, so f has to be thread safe */
+	void bake(const BatchFunction &f);
+	/** Largest absolute difference between the interpolated grid and f at n
+	 * random positions inside the grid; maxValue is set to the largest |f|
+	 * among them */
+	double maxError(const BatchFunction &f, std::size_t n, double &maxValue,
+	                int seed = 42) const;
+
+	/** Position of a grid point */
+	Vector3QLength getPosition(size_t ix, size_t iy, size_t iz) const;
+	/** True between the first and the last grid planes of every axis */
+	bool isInside(const Vector3QLength &pos) const;
+	/** Trilinear interpolation, only meaningful for isInside() positions */
+	double interpolate(const Vector3QLength &pos) const;
+
+	bool isUniform() const { return zAxis.empty(); }
+	std::shared_ptr<ScalarGrid> getGrid() const { return grid; }
+	size_t getNx() const { return grid->getNx(); }
+	size_t getNy() const { return grid->getNy(); }
+	size_t getNz() const { return grid->getNz(); }
+};
+
+/** @}*/
+}  // namespace hermes
+
+#endif  // HERMES_BAKEDGRID_H
@@ -6,6 +6,7 @@
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <tuple>
 #include <unordered_map>
@@ -232,6 +233,46 @@ class CacheStorageIC2 {
 	}
 };
 
+/**
+ * Value which depends only on the skymap parameter (a frequency or energy)
+ * and is shared by all threads of a skymap computation; it is computed
+ * on the first request and again whenever another parameter is requested.
+ * Copies share the cached value but not the lock.
+ */
+template <typename QSTEP, typename V>
+class ParameterCache {
+  private:
+	typedef std::pair<QSTEP, V> tEntry;
+	mutable std::shared_ptr<const tEntry> entry;
+	mutable std::mutex mtx;
+
+  public:
+	ParameterCache() {}
+	ParameterCache(const ParameterCache &other)
+	    : entry(std::atomic_load(&other.entry)) {}
+	ParameterCache &operator=(const ParameterCache &other) {
+		std::atomic_store(&entry, std::atomic_load(&other.entry));
+		return *this;
+	}
+
+	/** Get the value for p, compute(p) is called only on a miss */
+	template <typename F>
+	std::shared_ptr<const V> get(const QSTEP &p, F compute) const {
+		auto e = std::atomic_load(&entry);
+		if (!e || e->first != p) {
+			std::lock_guard<std::mutex> guard(mtx);
+			e = std::atomic_load(&entry);
+			if (!e || e->first != p) {
+				e = std::make_shared<const tEntry>(p, compute(p));
+				std::atomic_store(&entry, e);
+			}
+		}
+		return std::shared_ptr<const V>(e, &e->second);
+	}
+
+	void clear() { std::atomic_store(&entry, std::shared_ptr<const tEntry>()); }
+};
+
 typedef CacheStorageWith3Args<int, int, QEnergy, QGREmissivity> CacheStorageIC;
 typedef CacheStorageWith2Args<QEnergy, QEnergy, QDiffCrossSection>
     CacheStorageCrossSection;
@@ -4,6 +4,7 @@
 #define HERMES_FITSWRAPPER_H
 
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -155,6 +156,19 @@ class FITSFile {
 	                void *array);
 	std::vector<float> readImageAsFloat(unsigned int firstElement,
 	                                    unsigned int nElements);
+	std::vector<long> getImageSize();
+	/** Read the rectangular subset [first, last] (1-based, inclusive, one
+	 * entry per axis) of the current image */
+	std::vector<float> readImageSubsetAsFloat(const std::vector<long> &first,
+	                                          const std::vector<long> &last);
+	/** Read the current image, seen as nPlanes planes of planeSize elements,
+	 * in slabs of planesPerSlab planes and pass every slab to
+	 * process(firstPlane, nPlanesInSlab, data). The next slab is read (and
+	 * decompressed) while process() works on the previous one. */
+	void readImageInSlabs(
+	    std::size_t planeSize, std::size_t nPlanes, std::size_t planesPerSlab,
+	    const std::function<void(std::size_t, std::size_t,
+	                             const std::vector<float> &)> &process);
 
 	void createTable(FITS::HDUType, long int nRows, int nColumns,
 	                 char *columnName[], char *columnType[], char *columnUnit[],
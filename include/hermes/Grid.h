@@ -8,6 +8,8 @@
 
 #include <algorithm>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "hermes/Vector3.h"
@@ -37,6 +39,118 @@ inline double round(double r) {
  * \addtogroup Core
  * @{
  */
+
+/**
+ @class LinearLayout
+ @brief Default storage order of Grid: x-major, z is the fastest running index
+
+ A step along y or z moves by Nz or Ny*Nz elements in memory.
+ */
+class LinearLayout {
+	size_t Nx, Ny, Nz;
+
+  public:
+	LinearLayout() : Nx(0), Ny(0), Nz(0) {}
+
+	void setGridSize(size_t Nx, size_t Ny, size_t Nz) {
+		this->Nx = Nx;
+		this->Ny = Ny;
+		this->Nz = Nz;
+	}
+
+	/** Number of elements the storage has to hold */
+	size_t getStorageSize() const { return Nx * Ny * Nz; }
+
+	/** Storage offsets along the single axes, the storage index of
+	 * (ix, iy, iz) is offsetX(ix) + offsetY(iy) + offsetZ(iz) */
+	size_t offsetX(size_t ix) const { return ix * Ny * Nz; }
+	size_t offsetY(size_t iy) const { return iy * Nz; }
+	size_t offsetZ(size_t iz) const { return iz; }
+
+	/** Storage index of the grid point (ix, iy, iz) */
+	size_t index(size_t ix, size_t iy, size_t iz) const {
+		return offsetX(ix) + offsetY(iy) + offsetZ(iz);
+	}
+
+	/** Grid point of a given storage index */
+	void indexToPoint(size_t index, size_t &ix, size_t &iy,
+	                  size_t &iz) const {
+		ix = index / (Ny * Nz);
+		iy = (index / Nz) % Ny;
+		iz = index % Nz;
+	}
+};
+
+/** Integer base-2 logarithm of a power of two */
+constexpr size_t log2i(size_t n) { return (n > 1) ? 1 + log2i(n >> 1) : 0; }
+
+/**
+ @class BrickedLayout
+ @brief Tiled storage order of Grid: the volume is split into bricks of
+ B x B x B points which are stored contiguously
+
+ All eight neighbours needed by the trilinear interpolation usually lie in
+ the same brick (B^3 elements, i.e. a few kB), so rays running in any
+ direction stay in cache. Bricks and points inside a brick are both x-major.
+ Grid sizes which are not a multiple of B are padded up to the next brick;
+ the padding elements are never read by get() or interpolate().
+ */
+template <size_t B = 8>
+class BrickedLayout {
+	static_assert(B > 0 && (B & (B - 1)) == 0,
+	              "BrickedLayout: brick size has to be a power of two");
+
+	static constexpr size_t S = log2i(B);
+	static constexpr size_t mask = B - 1;
+
+	size_t Nx, Ny, Nz;
+	size_t NBy, NBz; /**< Number of bricks along y and z */
+	size_t NB;       /**< Total number of bricks */
+
+  public:
+	BrickedLayout() : Nx(0), Ny(0), Nz(0), NBy(0), NBz(0), NB(0) {}
+
+	void setGridSize(size_t Nx, size_t Ny, size_t Nz) {
+		this->Nx = Nx;
+		this->Ny = Ny;
+		this->Nz = Nz;
+		NBy = (Ny + mask) >> S;
+		NBz = (Nz + mask) >> S;
+		NB = ((Nx + mask) >> S) * NBy * NBz;
+	}
+
+	/** Number of elements the storage has to hold, including padding */
+	size_t getStorageSize() const { return NB << (3 * S); }
+
+	/** Storage offsets along the single axes, the storage index of
+	 * (ix, iy, iz) is offsetX(ix) + offsetY(iy) + offsetZ(iz) */
+	size_t offsetX(size_t ix) const {
+		return ((ix >> S) * NBy * NBz << (3 * S)) + ((ix & mask) << (2 * S));
+	}
+	size_t offsetY(size_t iy) const {
+		return ((iy >> S) * NBz << (3 * S)) + ((iy & mask) << S);
+	}
+	size_t offsetZ(size_t iz) const {
+		return ((iz >> S) << (3 * S)) + (iz & mask);
+	}
+
+	/** Storage index of the grid point (ix, iy, iz) */
+	size_t index(size_t ix, size_t iy, size_t iz) const {
+		return offsetX(ix) + offsetY(iy) + offsetZ(iz);
+	}
+
+	/** Grid point of a given storage index; padding elements map to points
+	 * outside of [0, Nx) x [0, Ny) x [0, Nz) */
+	void indexToPoint(size_t index, size_t &ix, size_t &iy,
+	                  size_t &iz) const {
+		size_t brick = index >> (3 * S);
+		size_t inner = index & ((size_t(1) << (3 * S)) - 1);
+		ix = ((brick / (NBy * NBz)) << S) | (inner >> (2 * S));
+		iy = (((brick / NBz) % NBy) << S) | ((inner >> S) & mask);
+		iz = ((brick % NBz) << S) | (inner & mask);
+	}
+};
+
 /**
  @class Grid2D
  @brief Template class for fields on a periodic grid with trilinear
@@ -227,10 +341,22 @@ class Grid2D {
  Values are calculated by trilinear interpolation of the surrounding 8 grid
  points. The grid is periodically (default) or reflectively extended. The grid
  sample positions are at 1/2 * size/N, 3/2 * size/N ... (2N-1)/2 * size/N.
+
+ The order in which the values are kept in memory is given by the Layout
+ policy (LinearLayout or BrickedLayout). It only matters for the raw storage
+ accessors (get(index), getGrid(), getStorageSize(), setVector(),
+ addVector(), positionFromIndex()); all (ix, iy, iz) accessors and
+ interpolate() behave the same for every layout. pushValue() is only
+ available with LinearLayout.
+
+ The values are held by the Storage policy, a std::vector by default or a
+ memory-mapped file (MappedStorage.h).
  */
-template <typename T>
+template <typename T, typename Layout = LinearLayout,
+          typename Storage = std::vector<T>>
 class Grid {
-	std::vector<T> grid;
+	Storage grid;
+	Layout layout;
 	size_t Nx, Ny, Nz;   /**< Number of grid points */
 	Vector3d origin;     /**< Origin of the volume that is represented by the
 	            grid. */
@@ -281,6 +407,36 @@ class Grid {
 		setReflective(false);
 	}
 
+	/** Constructor for a grid on top of existing storage, e.g. a mapped file
+	 @param	storage	Values, their number has to match the grid size
+	 @param	origin	Position of the lower left front corner of the volume
+	 @param	Nx		Number of grid points in x-direction
+	 @param	Ny		Number of grid points in y-direction
+	 @param	Nz		Number of grid points in z-direction
+	 @param spacing	Spacing vector between grid points
+	*/
+	Grid(Storage &&storage, Vector3d origin, size_t Nx, size_t Ny, size_t Nz,
+	     Vector3d spacing)
+	    : grid(std::move(storage)) {
+		setOrigin(origin);
+		setGridSize(Nx, Ny, Nz);
+		setSpacing(spacing);
+		setReflective(false);
+	}
+
+	/** Copy of a grid with another storage layout or storage */
+	template <typename OtherLayout, typename OtherStorage>
+	explicit Grid(const Grid<T, OtherLayout, OtherStorage> &other) {
+		setOrigin(other.getOrigin());
+		setGridSize(other.getNx(), other.getNy(), other.getNz());
+		setSpacing(other.getSpacing());
+		setReflective(other.isReflective());
+		for (size_t ix = 0; ix < Nx; ix++)
+			for (size_t iy = 0; iy < Ny; iy++)
+				for (size_t iz = 0; iz < Nz; iz++)
+					get(ix, iy, iz) = other.get(ix, iy, iz);
+	}
+
 	void setOrigin(Vector3d origin) {
 		this->origin = origin;
 		this->gridOrigin = origin + spacing / 2;
@@ -292,11 +448,17 @@ class Grid {
 		this->Nx = Nx;
 		this->Ny = Ny;
 		this->Nz = Nz;
-		grid.resize(Nx * Ny * Nz);
+		layout.setGridSize(Nx, Ny, Nz);
+		grid.resize(layout.getStorageSize());
 		setOrigin(origin);
 	}
 
-	size_t getGridSize() const { return grid.size(); }
+	/** Number of grid points, Nx * Ny * Nz */
+	size_t getGridSize() const { return Nx * Ny * Nz; }
+
+	/** Number of elements in the raw storage, larger than getGridSize()
+	 * when the layout pads the grid */
+	size_t getStorageSize() const { return grid.size(); }
 
 	void setSpacing(Vector3d spacing) {
 		this->spacing = spacing;
@@ -317,7 +479,13 @@ class Grid {
 		               [](T el1, T el2) { return (el1 + el2); });
 	}
 
-	void pushValue(T value) { grid.push_back(value); }
+	/** Appends a value to the raw storage, which is the next grid point
+	 * only in the LinearLayout */
+	void pushValue(T value) {
+		static_assert(std::is_same<Layout, LinearLayout>::value,
+		              "Grid::pushValue: only available with LinearLayout");
+		grid.push_back(value);
+	}
 
 	Vector3d getOrigin() const { return origin; }
 	size_t getNx() const { return Nx; }
@@ -330,37 +498,36 @@ class Grid {
 
 	/** Inspector & Mutator */
 	T &get(size_t ix, size_t iy, size_t iz) {
-		return grid[ix * Ny * Nz + iy * Nz + iz];
+		return grid[layout.index(ix, iy, iz)];
 	}
 
-	/** Inspector & Mutator */
+	/** Inspector & Mutator of the raw storage */
 	T &get(size_t index) { return grid[index]; }
 
 	/** Inspector */
 	const T &get(size_t ix, size_t iy, size_t iz) const {
-		return grid[ix * Ny * Nz + iy * Nz + iz];
+		return grid[layout.index(ix, iy, iz)];
 	}
 
 	T getValue(size_t ix, size_t iy, size_t iz) {
-		return grid[ix * Ny * Nz + iy * Nz + iz];
+		return grid[layout.index(ix, iy, iz)];
 	}
 
 	void setValue(size_t ix, size_t iy, size_t iz, T value) {
-		grid[ix * Ny * Nz + iy * Nz + iz] = value;
+		grid[layout.index(ix, iy, iz)] = value;
 	}
 
 	void addValue(size_t ix, size_t iy, size_t iz, T value) {
-		grid[ix * Ny * Nz + iy * Nz + iz] += value;
+		grid[layout.index(ix, iy, iz)] += value;
 	}
 
-	/** Return a reference to the grid values */
-	std::vector<T> &getGrid() { return grid; }
+	/** Return a reference to the grid values (in storage order) */
+	Storage &getGrid() { return grid; }
 
-	/** Position of the grid point of a given index */
+	/** Position of the grid point of a given storage index */
 	Vector3d positionFromIndex(int index) const {
-		int ix = index / (Ny * Nz);
-		int iy = (index / Nz) % Ny;
-		int iz = index % Nz;
+		size_t ix, iy, iz;
+		layout.indexToPoint(index, ix, iy, iz);
 		return Vector3d(ix, iy, iz) * spacing + gridOrigin;
 	}
 
@@ -407,25 +574,30 @@ class Grid {
 		double fz = r.z - floor(r.z);
 		double fZ = 1 - fz;
 
+		// storage offsets of the neighbors along each axis
+		size_t ox = layout.offsetX(ix), oX = layout.offsetX(iX);
+		size_t oy = layout.offsetY(iy), oY = layout.offsetY(iY);
+		size_t oz = layout.offsetZ(iz), oZ = layout.offsetZ(iZ);
+
 		// trilinear interpolation (see
 		// http://paulbourke.net/miscellaneous/interpolation)
 		T b(0.);
 		// V000 (1 - x) (1 - y) (1 - z) +
-		b += get(ix, iy, iz) * fX * fY * fZ;
+		b += grid[ox + oy + oz] * fX * fY * fZ;
 		// V100 x (1 - y) (1 - z) +
-		b += get(iX, iy, iz) * fx * fY * fZ;
+		b += grid[oX + oy + oz] * fx * fY * fZ;
 		// V010 (1 - x) y (1 - z) +
-		b += get(ix, iY, iz) * fX * fy * fZ;
+		b += grid[ox + oY + oz] * fX * fy * fZ;
 		// V001 (1 - x) (1 - y) z +
-		b += get(ix, iy, iZ) * fX * fY * fz;
+		b += grid[ox + oy + oZ] * fX * fY * fz;
 		// V101 x (1 - y) z +
-		b += get(iX, iy, iZ) * fx * fY * fz;
+		b += grid[oX + oy + oZ] * fx * fY * fz;
 		// V011 (1 - x) y z +
-		b += get(ix, iY, iZ) * fX * fy * fz;
+		b += grid[ox + oY + oZ] * fX * fy * fz;
 		// V110 x y (1 - z) +
-		b += get(iX, iY, iz) * fx * fy * fZ;
+		b += grid[oX + oY + oz] * fx * fy * fZ;
 		// V111 x y z
-		b += get(iX, iY, iZ) * fx * fy * fz;
+		b += grid[oX + oY + oZ] * fx * fy * fz;
 
 		return b;
 	}
@@ -438,6 +610,8 @@ typedef Grid<QPDensityPerEnergy> ScalarGridQPDensityPerEnergy;
 typedef Grid<Vector3f> VectorGrid;
 typedef Grid<Vector3QLength> VectorQLengthGrid;
 typedef Grid<Vector3QMField> VectorQMFieldGrid;
+typedef Grid<float, BrickedLayout<>> BrickedScalarGrid;
+typedef Grid<Vector3f, BrickedLayout<>> BrickedVectorGrid;
 
 /** @}*/
 
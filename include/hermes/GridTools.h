@@ -1,9 +1,13 @@
 #ifndef HERMES_GRIDTOOLS_H
 #define HERMES_GRIDTOOLS_H
 
+#include <cstring>
+#include <fstream>
+#include <sstream>
 #include <string>
 
 #include "hermes/Grid.h"
+#include "hermes/MappedStorage.h"
 #include "hermes/magneticfields/MagneticField.h"
 
 /**
@@ -19,6 +23,11 @@
  stored per grid point in xyz-order. In case of plain-text files the vector
  components are separated by a blank or tab and grid points are stored one per
  line. All functions offer a conversion factor that is multiplied to all values.
+
+ Mapped grid files (dumpMappedGrid/loadMappedGrid) additionally carry a header
+ with the grid geometry and element type (MappedStorage.h). Loading them maps
+ the file into memory instead of reading it, so startup does not depend on
+ the grid size and processes on the same node share the values.
  */
 
 namespace hermes {
@@ -28,32 +37,37 @@ namespace hermes {
  */
 
 /** Evaluate the mean vector of all grid points */
-Vector3f meanFieldVector(std::unique_ptr<VectorGrid> grid);
+Vector3f meanFieldVector(const std::shared_ptr<VectorGrid> &grid);
 
 /** Evaluate the mean of all grid points */
-double meanFieldStrength(std::unique_ptr<ScalarGrid> grid);
+double meanFieldStrength(const std::shared_ptr<ScalarGrid> &grid);
 /** Evaluate the mean of all grid points */
-double meanFieldStrength(std::unique_ptr<VectorGrid> grid);
+double meanFieldStrength(const std::shared_ptr<VectorGrid> &grid);
 
 /** Evaluate the RMS of all grid points */
-double rmsFieldStrength(std::unique_ptr<ScalarGrid> grid);
+double rmsFieldStrength(const std::shared_ptr<ScalarGrid> &grid);
 /** Evaluate the RMS of all grid points */
-double rmsFieldStrength(std::unique_ptr<VectorGrid> grid);
+double rmsFieldStrength(const std::shared_ptr<VectorGrid> &grid);
 
 /** Multiply all grid values by a given factor */
-void scaleGrid(std::unique_ptr<ScalarGrid> grid, double a);
+void scaleGrid(const std::shared_ptr<ScalarGrid> &grid, double a);
 /** Multiply all grid values by a given factor */
-void scaleGrid(std::unique_ptr<VectorGrid> grid, double a);
+void scaleGrid(const std::shared_ptr<VectorGrid> &grid, double a);
 
 #ifdef HERMES_HAVE_FFTW3F
 /**
  Create a random initialization of a turbulent field.
+
+ k-space is filled by getThreadsNumber() threads and the components are
+ transformed one after the other, so only a single component of B(k) is held
+ besides the grid. The modes are drawn with CounterRandom from the seed and
+ their k-space index, so the realization only depends on the seed.
  @param lMin	Minimum wavelength of the turbulence
  @param lMax	Maximum wavelength of the turbulence
  @param alpha	Power law index of <B^2(k)> ~ k^alpha (alpha = -11/3 corresponds
  to a Kolmogorov spectrum)
  @param Brms	RMS field strength
- @param seed	Random seed
+ @param seed	Random seed, 0 for a random one
  @param helicity Turn on/off helicity
  @param H		helicity parameter
  */
@@ -67,45 +81,105 @@ double turbulentCorrelationLength(double lMin, double lMax,
                                   double alpha = (-11. / 3.));
 
 /** Fill vector grid from provided magnetic field */
-void fromMagneticField(std::unique_ptr<VectorGrid> grid,
-                       std::unique_ptr<magneticfields::MagneticField> field);
+void fromMagneticField(
+    const std::shared_ptr<VectorGrid> &grid,
+    const std::shared_ptr<magneticfields::MagneticField> &field);
 
 /** Fill scalar grid from provided magnetic field */
 void fromMagneticFieldStrength(
-    std::unique_ptr<ScalarGrid> grid,
-    std::unique_ptr<magneticfields::MagneticField> field);
+    const std::shared_ptr<ScalarGrid> &grid,
+    const std::shared_ptr<magneticfields::MagneticField> &field);
 
 /** Load a VectorGrid from a binary file with single precision */
-void loadGrid(std::unique_ptr<VectorGrid> grid, std::string filename,
-              double conversion = 1);
+void loadGrid(const std::shared_ptr<VectorGrid> &grid,
+              const std::string &filename, double conversion = 1);
 
 /** Load a ScalarGrid from a binary file with single precision */
-void loadGrid(std::unique_ptr<ScalarGrid> grid, std::string filename,
-              double conversion = 1);
+void loadGrid(const std::shared_ptr<ScalarGrid> &grid,
+              const std::string &filename, double conversion = 1);
 
 /** Dump a VectorGrid to a binary file */
-void dumpGrid(std::unique_ptr<VectorGrid> grid, std::string filename,
-              double conversion = 1);
+void dumpGrid(const std::shared_ptr<VectorGrid> &grid,
+              const std::string &filename, double conversion = 1);
 
 /** Dump a ScalarGrid to a binary file with single precision */
-void dumpGrid(std::unique_ptr<ScalarGrid> grid, std::string filename,
-              double conversion = 1);
+void dumpGrid(const std::shared_ptr<ScalarGrid> &grid,
+              const std::string &filename, double conversion = 1);
 
 /** Load a VectorGrid grid from a plain text file */
-void loadGridFromTxt(std::unique_ptr<VectorGrid> grid, std::string filename,
-                     double conversion = 1);
+void loadGridFromTxt(const std::shared_ptr<VectorGrid> &grid,
+                     const std::string &filename, double conversion = 1);
 
 /** Load a ScalarGrid from a plain text file */
-void loadGridFromTxt(std::unique_ptr<ScalarGrid> grid, std::string filename,
-                     double conversion = 1);
+void loadGridFromTxt(const std::shared_ptr<ScalarGrid> &grid,
+                     const std::string &filename, double conversion = 1);
 
 /** Dump a VectorGrid to a plain text file */
-void dumpGridToTxt(std::unique_ptr<VectorGrid> grid, std::string filename,
-                   double conversion = 1);
+void dumpGridToTxt(const std::shared_ptr<VectorGrid> &grid,
+                   const std::string &filename, double conversion = 1);
 
 /** Dump a ScalarGrid to a plain text file */
-void dumpGridToTxt(std::unique_ptr<ScalarGrid> grid, std::string filename,
-                   double conversion = 1);
+void dumpGridToTxt(const std::shared_ptr<ScalarGrid> &grid,
+                   const std::string &filename, double conversion = 1);
+
+/** Dump any grid to a binary file with header which can be memory-mapped
+ * by loadMappedGrid() */
+template <typename T, typename Layout, typename Storage>
+void dumpMappedGrid(const Grid<T, Layout, Storage> &grid,
+                    const std::string &filename) {
+	std::ofstream fout(filename.c_str(), std::ios::binary);
+	if (!fout) {
+		std::stringstream ss;
+		ss << "dump MappedGrid: " << filename << " not found";
+		throw std::runtime_error(ss.str());
+	}
+
+	GridFileHeader header = {};
+	std::memcpy(header.magic, "HRMSGRID", 8);
+	header.version = GridFileHeader::currentVersion;
+	header.element = GridElementType<T>::code;
+	header.dimension = GridElementType<T>::dimension();
+	header.elementSize = sizeof(T);
+	header.Nx = grid.getNx();
+	header.Ny = grid.getNy();
+	header.Nz = grid.getNz();
+	Vector3d origin = grid.getOrigin();
+	Vector3d spacing = grid.getSpacing();
+	header.origin[0] = origin.x;
+	header.origin[1] = origin.y;
+	header.origin[2] = origin.z;
+	header.spacing[0] = spacing.x;
+	header.spacing[1] = spacing.y;
+	header.spacing[2] = spacing.z;
+	header.reflective = grid.isReflective();
+	header.dataOffset = GridFileHeader::defaultDataOffset;
+	MappedFile::writeHeader(fout, header);
+
+	for (size_t ix = 0; ix < grid.getNx(); ix++)
+		for (size_t iy = 0; iy < grid.getNy(); iy++)
+			for (size_t iz = 0; iz < grid.getNz(); iz++)
+				fout.write((const char *)&grid.get(ix, iy, iz), sizeof(T));
+	if (!fout)
+		throw std::runtime_error("dump MappedGrid: cannot write " + filename);
+	fout.close();
+}
+
+/** Map a grid file written by dumpMappedGrid(); values are paged in on first
+ * access. Writable grids modify the file, read-only grids must not be
+ * written to. */
+template <typename T>
+std::shared_ptr<Grid<T, LinearLayout, MappedStorage<T>>> loadMappedGrid(
+    const std::string &filename, bool writable = false) {
+	MappedStorage<T> storage(filename, writable);
+	GridFileHeader header = storage.getHeader();
+	auto grid = std::make_shared<Grid<T, LinearLayout, MappedStorage<T>>>(
+	    std::move(storage),
+	    Vector3d(header.origin[0], header.origin[1], header.origin[2]),
+	    header.Nx, header.Ny, header.Nz,
+	    Vector3d(header.spacing[0], header.spacing[1], header.spacing[2]));
+	grid->setReflective(header.reflective != 0);
+	return grid;
+}
 
 /** @}*/
 }  // namespace hermes
@@ -0,0 +1,230 @@
+#ifndef HERMES_MAPPEDSTORAGE_H
+#define HERMES_MAPPEDSTORAGE_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <ratio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "hermes/Grid.h"
+
+namespace hermes {
+/**
+ * \addtogroup Core
+ * @{
+ */
+
+/** Element type codes of the grid file header */
+enum class GridElementCode : std::uint32_t {
+	Float = 1,
+	Double = 2,
+	Vector3f = 3,
+	Vector3d = 4
+};
+
+/** Exponents of the nine base units of units::Quantity, in its order:
+ * the nine numerators followed by the nine denominators */
+typedef std::array<std::int32_t, 18> GridElementDimension;
+
+/** Dimension of the given exponents, which are std::ratio types */
+template <typename... Exponents>
+GridElementDimension makeGridElementDimension() {
+	static_assert(sizeof...(Exponents) == 9,
+	              "makeGridElementDimension: nine exponents expected");
+	return {{static_cast<std::int32_t>(Exponents::num)...,
+	         static_cast<std::int32_t>(Exponents::den)...}};
+}
+
+/** Dimension of plain numbers, all exponents are 0/1 */
+inline GridElementDimension dimensionlessGridElement() {
+	return makeGridElementDimension<std::ratio<0>, std::ratio<0>,
+	                                std::ratio<0>, std::ratio<0>,
+	                                std::ratio<0>, std::ratio<0>,
+	                                std::ratio<0>, std::ratio<0>,
+	                                std::ratio<0>>();
+}
+
+/** Maps the grid value type to its element code and dimension; quantities
+ * with units are stored as plain doubles in SI units, with the exponents
+ * of their unit in the header */
+template <typename T>
+struct GridElementType;
+template <>
+struct GridElementType<float> {
+	static constexpr GridElementCode code = GridElementCode::Float;
+	static GridElementDimension dimension() {
+		return dimensionlessGridElement();
+	}
+};
+template <>
+struct GridElementType<double> {
+	static constexpr GridElementCode code = GridElementCode::Double;
+	static GridElementDimension dimension() {
+		return dimensionlessGridElement();
+	}
+};
+template <>
+struct GridElementType<Vector3f> {
+	static constexpr GridElementCode code = GridElementCode::Vector3f;
+	static GridElementDimension dimension() {
+		return dimensionlessGridElement();
+	}
+};
+template <>
+struct GridElementType<Vector3d> {
+	static constexpr GridElementCode code = GridElementCode::Vector3d;
+	static GridElementDimension dimension() {
+		return dimensionlessGridElement();
+	}
+};
+template <typename l, typename t, typename m, typename I, typename T,
+          typename N, typename J, typename A, typename SA>
+struct GridElementType<units::Quantity<l, t, m, I, T, N, J, A, SA>> {
+	static_assert(sizeof(units::Quantity<l, t, m, I, T, N, J, A, SA>) ==
+	                  sizeof(double),
+	              "GridElementType: Quantity is expected to wrap a double");
+	static constexpr GridElementCode code = GridElementCode::Double;
+	static GridElementDimension dimension() {
+		return makeGridElementDimension<l, t, m, I, T, N, J, A, SA>();
+	}
+};
+
+/**
+ @struct GridFileHeader
+ @brief Header of a binary grid file which can be memory-mapped
+
+ The header is followed, at dataOffset (one page), by Nx*Ny*Nz values in
+ native byte order with the z-index changing the fastest.
+ */
+struct GridFileHeader {
+	char magic[8];             /**< "HRMSGRID" */
+	std::uint32_t version;     /**< File format version */
+	GridElementCode element;   /**< Type of the stored values */
+	std::uint64_t Nx, Ny, Nz;  /**< Number of grid points */
+	double origin[3];          /**< Origin of the volume */
+	double spacing[3];         /**< Distance between grid points */
+	std::uint32_t reflective;  /**< Grid is repeated reflectively */
+	std::uint32_t elementSize; /**< sizeof() of a single value */
+	std::uint64_t dataOffset;  /**< Position of the first value in the file */
+	GridElementDimension dimension; /**< Unit of the values (version 2) */
+
+	static constexpr std::uint32_t currentVersion = 2;
+	static constexpr std::uint64_t defaultDataOffset = 4096;
+};
+
+/**
+ @class MappedFile
+ @brief RAII handle of a memory-mapped binary grid file
+
+ Files are mapped shared, so several processes use the same physical
+ pages through the page cache. Read-only files are mapped without write
+ permission: writing to their values is a segmentation fault. Writable
+ files are modified in place. Files of version 1 carry no unit and can
+ only be read into grids of plain numbers.
+ */
+class MappedFile {
+	std::string filename;
+	GridFileHeader header;
+	void *address;
+	std::size_t length;
+
+	void unmap();
+
+  public:
+	MappedFile();
+	MappedFile(const std::string &filename, bool writable = false);
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	/** Write the header, padded up to header.dataOffset, to a grid file */
+	static void writeHeader(std::ostream &out, const GridFileHeader &header);
+
+	bool isMapped() const { return address != nullptr; }
+	const GridFileHeader &getHeader() const { return header; }
+	const std::string &getFilename() const { return filename; }
+	void *getData() const;
+};
+
+/**
+ @class MappedStorage
+ @brief Grid storage policy backed by a memory-mapped grid file
+
+ Provides the subset of the std::vector interface used by Grid. The storage
+ cannot grow; resizing to anything else than the number of mapped values
+ throws.
+ */
+template <typename T>
+class MappedStorage {
+	MappedFile file;
+	T *values;
+	std::size_t n;
+
+  public:
+	MappedStorage() : values(nullptr), n(0) {}
+
+	/** Map a grid file, the stored element type and unit have to match T */
+	MappedStorage(const std::string &filename, bool writable = false)
+	    : file(filename, writable) {
+		const GridFileHeader &h = file.getHeader();
+		if (h.element != GridElementType<T>::code ||
+		    h.elementSize != sizeof(T))
+			throw std::runtime_error(
+			    "MappedStorage: element type of " + filename +
+			    " does not match the grid type");
+		GridElementDimension dimension = (h.version < 2)
+		                                     ? dimensionlessGridElement()
+		                                     : h.dimension;
+		if (dimension != GridElementType<T>::dimension())
+			throw std::runtime_error("MappedStorage: unit of " + filename +
+			                         " does not match the grid type");
+		values = static_cast<T *>(file.getData());
+		n = h.Nx * h.Ny * h.Nz;
+	}
+
+	MappedStorage(MappedStorage &&other) noexcept
+	    : file(std::move(other.file)), values(other.values), n(other.n) {
+		other.values = nullptr;
+		other.n = 0;
+	}
+	MappedStorage &operator=(MappedStorage &&other) noexcept {
+		file = std::move(other.file);
+		values = other.values;
+		n = other.n;
+		other.values = nullptr;
+		other.n = 0;
+		return *this;
+	}
+
+	const GridFileHeader &getHeader() const { return file.getHeader(); }
+
+	void resize(std::size_t size) {
+		if (size != n)
+			throw std::runtime_error(
+			    "MappedStorage: grid size does not match the mapped file");
+	}
+
+	std::size_t size() const { return n; }
+	T *data() { return values; }
+	const T *data() const { return values; }
+	T *begin() { return values; }
+	T *end() { return values + n; }
+	const T *begin() const { return values; }
+	const T *end() const { return values + n; }
+	T &operator[](std::size_t i) { return values[i]; }
+	const T &operator[](std::size_t i) const { return values[i]; }
+};
+
+typedef Grid<float, LinearLayout, MappedStorage<float>> MappedScalarGrid;
+typedef Grid<Vector3f, LinearLayout, MappedStorage<Vector3f>> MappedVectorGrid;
+
+/** @}*/
+}  // namespace hermes
+
+#endif  // HERMES_MAPPEDSTORAGE_H
@@ -232,6 +232,40 @@ class Random {
 	/// Based on code by Lawrence Kirby (fred@genesis.demon.co.uk)
 	static uint32 hash(time_t t, clock_t c);
 };
+
+/**
+ @class CounterRandom
+ @brief Counter-based random number generator (Philox4x32-10).
+
+ The random numbers are a function of the key (seed) and a counter, e.g.
+ the index of a grid cell, and need no state: every counter can be drawn
+ independently, in any order and from any thread, with the same result.
+ Each counter gives a block of four 32-bit random integers.
+ See Salmon et al. 2011, Parallel random numbers: as easy as 1, 2, 3
+ */
+class CounterRandom {
+	uint32_t key[2];
+
+  public:
+	explicit CounterRandom(uint64_t seed);
+
+	/// Four random integers in [0, 2^32-1] for the given counter
+	void block(uint64_t counter, uint64_t stream, uint32_t out[4]) const;
+
+	/// Real number in (0,1) for the given counter
+	double rand(uint64_t counter, uint64_t stream = 0) const;
+
+	/// Real number in (0,1) from a random integer of a block
+	static double toUniform(uint32_t x) {
+		return (double(x) + 0.5) * (1.0 / 4294967296.0);
+	}
+	/// Normal distributed number (mean 0, sigma 1) from two random integers
+	/// of a block (Box-Muller)
+	static double toNormal(uint32_t a, uint32_t b) {
+		return std::sqrt(-2.0 * std::log(toUniform(a))) *
+		       std::cos(2 * M_PI * toUniform(b));
+	}
+};
 /** @}*/
 
 }  // namespace hermes
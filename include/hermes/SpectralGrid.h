@@ -0,0 +1,275 @@
+#ifndef HERMES_SPECTRALGRID_H
+#define HERMES_SPECTRALGRID_H
+
+#include <algorithm>
+#include <vector>
+
+#include "hermes/Grid.h"
+
+namespace hermes {
+/**
+ * \addtogroup Core
+ * @{
+ */
+
+/**
+ @class SpectralGrid2D
+ @brief Grid2D with a whole spectrum of NE values per grid point
+
+ The spectrum of each grid point is stored contiguously, so all energies at a
+ position are obtained with one set of bilinear weights and sequential reads.
+ Geometry and boundary handling are the same as for Grid2D.
+ */
+template <typename T>
+class SpectralGrid2D {
+	std::vector<T> grid;
+	size_t Nx, Ny, NE;   /**< Number of grid points and energies */
+	Vector3d origin;     /**< Origin of the volume that is represented by the
+	            grid. */
+	Vector3d gridOrigin; /**< Grid origin */
+	Vector3d spacing;    /**< Distance between grid points */
+	bool reflective;     /**< If set to true, the grid is repeated reflectively
+	            instead of periodically */
+
+	/** Storage offsets and weights of the 4 neighbors of a position */
+	void neighbors(const Vector3d &position, size_t offset[4],
+	               double weight[4]) const {
+		Vector3d r = (position - gridOrigin) / spacing;
+
+		int ix, iX, iy, iY;
+		if (reflective) {
+			reflectiveClamp(r.x, Nx, ix, iX);
+			reflectiveClamp(r.y, Ny, iy, iY);
+		} else {
+			periodicClamp(r.x, Nx, ix, iX);
+			periodicClamp(r.y, Ny, iy, iY);
+		}
+
+		double fx = r.x - floor(r.x);
+		double fX = 1 - fx;
+		double fy = r.y - floor(r.y);
+		double fY = 1 - fy;
+
+		offset[0] = (ix * Ny + iy) * NE;
+		weight[0] = fX * fY;
+		offset[1] = (iX * Ny + iy) * NE;
+		weight[1] = fx * fY;
+		offset[2] = (ix * Ny + iY) * NE;
+		weight[2] = fX * fy;
+		offset[3] = (iX * Ny + iY) * NE;
+		weight[3] = fx * fy;
+	}
+
+  public:
+	/** Constructor
+	 @param	origin	Position of the lower left front corner of the volume
+	 @param	Nx		Number of grid points in x-direction
+	 @param	Ny		Number of grid points in y-direction
+	 @param	NE		Number of values (energies) per grid point
+	 @param spacing	Spacing vector between grid points
+	*/
+	SpectralGrid2D(Vector3d origin, size_t Nx, size_t Ny, size_t NE,
+	               Vector3d spacing)
+	    : Nx(Nx), Ny(Ny), NE(NE), spacing(spacing), reflective(false) {
+		setOrigin(origin);
+		grid.resize(Nx * Ny * NE);
+	}
+
+	void setOrigin(Vector3d origin) {
+		this->origin = origin;
+		this->gridOrigin = origin + spacing / 2;
+	}
+
+	Vector3d getOrigin() const { return origin; }
+	Vector3d getSpacing() const { return spacing; }
+	size_t getNx() const { return Nx; }
+	size_t getNy() const { return Ny; }
+	size_t getNE() const { return NE; }
+
+	void setReflective(bool b) { reflective = b; }
+	bool isReflective() const { return reflective; }
+
+	/** Inspector & Mutator */
+	T &get(size_t ix, size_t iy, size_t iE) {
+		return grid[(ix * Ny + iy) * NE + iE];
+	}
+
+	/** Inspector */
+	const T &get(size_t ix, size_t iy, size_t iE) const {
+		return grid[(ix * Ny + iy) * NE + iE];
+	}
+
+	void addValue(size_t ix, size_t iy, size_t iE, T value) {
+		grid[(ix * Ny + iy) * NE + iE] += value;
+	}
+
+	/** Interpolate a single energy of the grid at a given position */
+	T interpolate(const Vector3d &position, size_t iE) const {
+		size_t offset[4];
+		double weight[4];
+		neighbors(position, offset, weight);
+
+		T b(0.);
+		for (int i = 0; i < 4; ++i) b += grid[offset[i] + iE] * weight[i];
+		return b;
+	}
+
+	/** Interpolate all energies at a given position, the spectrum is resized
+	 * to NE */
+	void getSpectrum(const Vector3d &position, std::vector<T> &spectrum) const {
+		size_t offset[4];
+		double weight[4];
+		neighbors(position, offset, weight);
+
+		spectrum.assign(NE, T(0.));
+		for (int i = 0; i < 4; ++i) {
+			const T *v = &grid[offset[i]];
+			for (size_t iE = 0; iE < NE; ++iE)
+				spectrum[iE] += v[iE] * weight[i];
+		}
+	}
+};
+
+/**
+ @class SpectralGrid
+ @brief Grid with a whole spectrum of NE values per grid point
+
+ The spectrum of each grid point is stored contiguously, so all energies at a
+ position are obtained with one set of trilinear weights and sequential reads.
+ Geometry and boundary handling are the same as for Grid.
+ */
+template <typename T>
+class SpectralGrid {
+	std::vector<T> grid;
+	size_t Nx, Ny, Nz, NE; /**< Number of grid points and energies */
+	Vector3d origin;       /**< Origin of the volume that is represented by the
+	              grid. */
+	Vector3d gridOrigin;   /**< Grid origin */
+	Vector3d spacing;      /**< Distance between grid points */
+	bool reflective;       /**< If set to true, the grid is repeated
+	              reflectively instead of periodically */
+
+	size_t index(size_t ix, size_t iy, size_t iz) const {
+		return ((ix * Ny + iy) * Nz + iz) * NE;
+	}
+
+	/** Storage offsets and weights of the 8 neighbors of a position */
+	void neighbors(const Vector3d &position, size_t offset[8],
+	               double weight[8]) const {
+		Vector3d r = (position - gridOrigin) / spacing;
+
+		int ix, iX, iy, iY, iz, iZ;
+		if (reflective) {
+			reflectiveClamp(r.x, Nx, ix, iX);
+			reflectiveClamp(r.y, Ny, iy, iY);
+			reflectiveClamp(r.z, Nz, iz, iZ);
+		} else {
+			periodicClamp(r.x, Nx, ix, iX);
+			periodicClamp(r.y, Ny, iy, iY);
+			periodicClamp(r.z, Nz, iz, iZ);
+		}
+
+		double fx = r.x - floor(r.x);
+		double fX = 1 - fx;
+		double fy = r.y - floor(r.y);
+		double fY = 1 - fy;
+		double fz = r.z - floor(r.z);
+		double fZ = 1 - fz;
+
+		offset[0] = index(ix, iy, iz);
+		weight[0] = fX * fY * fZ;
+		offset[1] = index(iX, iy, iz);
+		weight[1] = fx * fY * fZ;
+		offset[2] = index(ix, iY, iz);
+		weight[2] = fX * fy * fZ;
+		offset[3] = index(ix, iy, iZ);
+		weight[3] = fX * fY * fz;
+		offset[4] = index(iX, iy, iZ);
+		weight[4] = fx * fY * fz;
+		offset[5] = index(ix, iY, iZ);
+		weight[5] = fX * fy * fz;
+		offset[6] = index(iX, iY, iz);
+		weight[6] = fx * fy * fZ;
+		offset[7] = index(iX, iY, iZ);
+		weight[7] = fx * fy * fz;
+	}
+
+  public:
+	/** Constructor
+	 @param	origin	Position of the lower left front corner of the volume
+	 @param	Nx		Number of grid points in x-direction
+	 @param	Ny		Number of grid points in y-direction
+	 @param	Nz		Number of grid points in z-direction
+	 @param	NE		Number of values (energies) per grid point
+	 @param spacing	Spacing vector between grid points
+	*/
+	SpectralGrid(Vector3d origin, size_t Nx, size_t Ny, size_t Nz, size_t NE,
+	             Vector3d spacing)
+	    : Nx(Nx), Ny(Ny), Nz(Nz), NE(NE), spacing(spacing), reflective(false) {
+		setOrigin(origin);
+		grid.resize(Nx * Ny * Nz * NE);
+	}
+
+	void setOrigin(Vector3d origin) {
+		this->origin = origin;
+		this->gridOrigin = origin + spacing / 2;
+	}
+
+	Vector3d getOrigin() const { return origin; }
+	Vector3d getSpacing() const { return spacing; }
+	size_t getNx() const { return Nx; }
+	size_t getNy() const { return Ny; }
+	size_t getNz() const { return Nz; }
+	size_t getNE() const { return NE; }
+
+	void setReflective(bool b) { reflective = b; }
+	bool isReflective() const { return reflective; }
+
+	/** Inspector & Mutator */
+	T &get(size_t ix, size_t iy, size_t iz, size_t iE) {
+		return grid[index(ix, iy, iz) + iE];
+	}
+
+	/** Inspector */
+	const T &get(size_t ix, size_t iy, size_t iz, size_t iE) const {
+		return grid[index(ix, iy, iz) + iE];
+	}
+
+	void addValue(size_t ix, size_t iy, size_t iz, size_t iE, T value) {
+		grid[index(ix, iy, iz) + iE] += value;
+	}
+
+	/** Interpolate a single energy of the grid at a given position */
+	T interpolate(const Vector3d &position, size_t iE) const {
+		size_t offset[8];
+		double weight[8];
+		neighbors(position, offset, weight);
+
+		T b(0.);
+		for (int i = 0; i < 8; ++i) b += grid[offset[i] + iE] * weight[i];
+		return b;
+	}
+
+	/** Interpolate all energies at a given position, the spectrum is resized
+	 * to NE */
+	void getSpectrum(const Vector3d &position, std::vector<T> &spectrum) const {
+		size_t offset[8];
+		double weight[8];
+		neighbors(position, offset, weight);
+
+		spectrum.assign(NE, T(0.));
+		for (int i = 0; i < 8; ++i) {
+			const T *v = &grid[offset[i]];
+			for (size_t iE = 0; iE < NE; ++iE)
+				spectrum[iE] += v[iE] * weight[i];
+		}
+	}
+};
+
+typedef SpectralGrid2D<QPDensityPerEnergy> SpectralGrid2DQPDensityPerEnergy;
+typedef SpectralGrid<QPDensityPerEnergy> SpectralGridQPDensityPerEnergy;
+
+/** @}*/
+}  // namespace hermes
+
+#endif  // HERMES_SPECTRALGRID_H
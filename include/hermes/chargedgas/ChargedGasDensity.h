@@ -1,6 +1,8 @@
 #ifndef HERMES_CHARGEDGASDENSITY_H
 #define HERMES_CHARGEDGASDENSITY_H
 
+#include <vector>
+
 #include "hermes/Grid.h"
 #include "hermes/Units.h"
 
@@ -19,6 +21,14 @@ class ChargedGasDensity {
 	ChargedGasDensity(QTemperature T) : gasTemp(T) {}
 	virtual ~ChargedGasDensity() {}
 	virtual QPDensity getDensity(const Vector3QLength &pos) const = 0;
+	/** Density at many positions with a single virtual call, densities is
+	 * resized to the number of positions */
+	virtual void getDensities(const std::vector<Vector3QLength> &positions,
+	                          std::vector<QPDensity> &densities) const {
+		densities.resize(positions.size());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			densities[i] = getDensity(positions[i]);
+	}
 
 	inline void setTemperature(QTemperature T) { gasTemp = T; }
 	inline QTemperature getTemperature() const { return gasTemp; }
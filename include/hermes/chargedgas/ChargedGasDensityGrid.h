@@ -0,0 +1,56 @@
+#ifndef HERMES_CHARGEDGASDENSITYGRID_H
+#define HERMES_CHARGEDGASDENSITYGRID_H
+
+#include <memory>
+#include <vector>
+
+#include "hermes/BakedGrid.h"
+#include "hermes/chargedgas/ChargedGasDensity.h"
+
+namespace hermes { namespace chargedgas {
+/**
+ * \addtogroup ChargedGas
+ * @{
+ */
+
+/**
+ @class ChargedGasDensityGrid
+ @brief Any ChargedGasDensity sampled on a BakedGrid and trilinearly
+ interpolated
+
+ Positions outside of the grid are passed to the baked model, or have zero
+ density if the grid was loaded from a file. The grid holds the density in
+ 1/m^3 and can be saved with dumpGrid(getGrid(), filename).
+ */
+class ChargedGasDensityGrid : public ChargedGasDensity {
+  private:
+	std::shared_ptr<ChargedGasDensity> model;
+	BakedGrid grid;
+	QPDensity maxError, maxDensity;
+
+  public:
+	/** Sample the model on the grid, in parallel and through its
+	 * getDensities(), and compare the result with the model at
+	 * validationPoints random positions inside the grid */
+	ChargedGasDensityGrid(const std::shared_ptr<ChargedGasDensity> &model,
+	                      const BakedGrid &grid,
+	                      std::size_t validationPoints = 10000);
+	/** Use an already filled grid, e.g. after loadGrid(grid.getGrid(), ..) */
+	ChargedGasDensityGrid(const BakedGrid &grid,
+	                      const QTemperature &T = 1e4_K);
+
+	QPDensity getDensity(const Vector3QLength &pos) const override;
+
+	/** Largest interpolation error found at the validation points */
+	QPDensity getMaxError() const { return maxError; }
+	/** Largest model density at the validation points */
+	QPDensity getMaxDensity() const { return maxDensity; }
+
+	const BakedGrid &getBakedGrid() const { return grid; }
+	std::shared_ptr<ScalarGrid> getGrid() const { return grid.getGrid(); }
+};
+
+/** @}*/
+}}  // namespace hermes::chargedgas
+
+#endif  // HERMES_CHARGEDGASDENSITYGRID_H
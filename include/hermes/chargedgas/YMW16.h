@@ -1,6 +1,8 @@
 #ifndef HERMES_YMW16_H
 #define HERMES_YMW16_H
 
+#include <vector>
+
 #include "hermes/chargedgas/ChargedGasDensity.h"
 
 /*Copyright (C) 2016, 2017  J. M. Yao, R. N. Manchester, N. Wang.
@@ -249,14 +251,34 @@ class YMW16 : public ChargedGasDensity {
 		double nsmc;
 	} t11;
 
+	bool cullingEnabled;
+
 	void initParameters();
 
+	/** ne_ymw16() of a point with precomputed cylindrical radius rr and
+	 * spherical radius R_g (pc) */
+	double ne_ymw16(double x, double y, double z, double rr,
+	                double R_g) const;
+	/** True if localbubble() returns 0 without using (gl, gb) */
+	bool outsideLocalBubble(double xx, double yy, double zz) const;
+
   public:
 	YMW16();
 	YMW16(const QTemperature &t);
 	QPDensity getDensity(const Vector3QLength &pos) const override;
+	void getDensities(const std::vector<Vector3QLength> &positions,
+	                  std::vector<QPDensity> &densities) const override;
+
+	/** The culls skip the components which are exactly 0 at a point; they
+	 * are on by default, disabling them runs the original code path */
+	void enableCulling();
+	void disableCulling();
+	bool isCullingEnabled() const;
 
 	double ne_ymw16(const Vector3QLength &pos) const;
+	/** Batch version of ne_ymw16(), ne is resized to positions.size() */
+	void ne_ymw16(const std::vector<Vector3QLength> &positions,
+	              std::vector<double> &ne) const;
 	double thick(double xx, double yy, double zz, double *gd, double rr) const;
 	double thin(double xx, double yy, double zz, double gd, double rr) const;
 	double galcen(double xx, double yy, double zz) const;
@@ -3,7 +3,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <map>
 #include <set>
+#include <stdexcept>
+#include <vector>
 
 #include "hermes/Grid.h"
 #include "hermes/ParticleID.h"
@@ -22,6 +25,17 @@ class CosmicRayDensity {
 	bool scaleFactorFlag;
 	double energyScaleFactor;
 	std::set<PID> setOfPIDs;
+	/** Weights the species were multiplied with, empty if unweighted */
+	std::map<PID, double> projectileWeights;
+
+	/** getSpectralShape() of separable models at the energy axis, filled
+	 * by cacheSpectralShape() */
+	std::vector<QPDensityPerEnergy> spectralShape;
+	void cacheSpectralShape() {
+		spectralShape.clear();
+		for (const auto &E : energyRange)
+			spectralShape.push_back(getSpectralShape(E));
+	}
 
 	void enablePID(const PID &pid_) { setOfPIDs.insert(pid_); }
 	void disablePID(const PID &pid_) { setOfPIDs.erase(setOfPIDs.find(pid_)); }
@@ -43,9 +57,64 @@ class CosmicRayDensity {
 
 	virtual QPDensityPerEnergy getDensityPerEnergy(
 	    const QEnergy &E_, const Vector3QLength &pos_) const = 0;
+	/** Density at the iE-th energy of the energy axis; grid-based models
+	 * override it to avoid looking up the energy */
+	virtual QPDensityPerEnergy getDensityPerEnergy(
+	    std::size_t iE_, const Vector3QLength &pos_) const {
+		if (isSeparable())
+			return getSpatialProfile(pos_) * spectralShape[iE_];
+		return getDensityPerEnergy(energyRange[iE_], pos_);
+	}
+	/** Density at the iE-th energy for many positions with a single
+	 * virtual call, densities is resized to the number of positions */
+	virtual void getDensitiesPerEnergy(
+	    std::size_t iE_, const std::vector<Vector3QLength> &positions,
+	    std::vector<QPDensityPerEnergy> &densities) const {
+		densities.resize(positions.size());
+		if (isSeparable()) {
+			for (std::size_t i = 0; i < positions.size(); ++i)
+				densities[i] =
+				    getSpatialProfile(positions[i]) * spectralShape[iE_];
+			return;
+		}
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			densities[i] = getDensityPerEnergy(iE_, positions[i]);
+	}
+	/** Density at all energies of the energy axis at a given position,
+	 * spectrum[i] corresponds to the i-th energy; grid-based models override
+	 * it to interpolate the whole spectrum at once */
+	virtual void getSpectrum(const Vector3QLength &pos_,
+	                         std::vector<QPDensityPerEnergy> &spectrum) const {
+		spectrum.resize(energyRange.size());
+		if (isSeparable()) {
+			QNumber profile = getSpatialProfile(pos_);
+			for (std::size_t i = 0; i < energyRange.size(); ++i)
+				spectrum[i] = profile * spectralShape[i];
+			return;
+		}
+		for (std::size_t i = 0; i < energyRange.size(); ++i)
+			spectrum[i] = getDensityPerEnergy(i, pos_);
+	}
+
+	/** Separable models, n(E, pos) = getSpatialProfile(pos) *
+	 * getSpectralShape(E), return true; integrators then compute their
+	 * energy integrals once and only evaluate the profile along the LOS */
+	virtual bool isSeparable() const { return false; }
+	/** Energy dependence of a separable model */
+	virtual QPDensityPerEnergy getSpectralShape(const QEnergy &E_) const {
+		throw std::runtime_error(
+		    "CosmicRayDensity::getSpectralShape: model is not separable");
+	}
+	/** Position dependence of a separable model */
+	virtual QNumber getSpatialProfile(const Vector3QLength &pos_) const {
+		throw std::runtime_error(
+		    "CosmicRayDensity::getSpatialProfile: model is not separable");
+	}
+	/** Index of E_ on the (ascending) energy axis, or the size of the axis
+	 * if E_ is not on it */
 	std::size_t getIndexOfE(const QEnergy &E_) const {
-		const_iterator it = std::find_if(
-		    begin(), end(), [E_](const auto &a) { return a == E_; });
+		const_iterator it = std::lower_bound(begin(), end(), E_);
+		if (it != end() && *it != E_) it = end();
 		return std::distance(begin(), it);
 	}
 	bool existsScaleFactor() const { return scaleFactorFlag; }
@@ -53,8 +122,23 @@ class CosmicRayDensity {
 	double getEnergyScaleFactor() const { return energyScaleFactor; }
 
 	tEnergyRange getEnergyAxis() const { return energyRange; }
+	/** Quantities tabulated on the energy axis of one density apply to the
+	 * other one as well */
+	bool hasSameEnergyAxis(const CosmicRayDensity &other) const {
+		return energyRange == other.energyRange;
+	}
 
 	PID getPID() const { return *setOfPIDs.begin(); }
+	/** The density is a sum over species, each already multiplied with its
+	 * projectile weight sum_t f_t sigma(p, t) for the gas targets t (see
+	 * DifferentialCrossSection::getProjectileWeights); pi0 integrators then
+	 * skip their own loop over targets */
+	bool isProjectileWeighted() const { return !projectileWeights.empty(); }
+	/** The weights the density was built with, checked by the pi0
+	 * integrators against their cross-section and gas abundances */
+	const std::map<PID, double> &getProjectileWeights() const {
+		return projectileWeights;
+	}
 
 	iterator beginAfterEnergy(const QEnergy &E_) {
 		return std::upper_bound(energyRange.begin(), energyRange.end(), E_);
@@ -3,11 +3,13 @@
 #ifndef HERMES_DRAGON3D_H
 #define HERMES_DRAGON3D_H
 
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
 
 #include "hermes/FITSWrapper.h"
+#include "hermes/SpectralGrid.h"
 #include "hermes/cosmicrays/CosmicRayDensity.h"
 
 namespace hermes { namespace cosmicrays {
@@ -25,26 +27,47 @@ class Dragon3D : public CosmicRayDensity {
 	void readEnergyAxis();
 	void readSpatialGrid3D();
 	void readDensity3D();
-	std::size_t calcArrayIndex2D(std::size_t iE, std::size_t ir,
-	                             std::size_t iz);
+	void scatterSlab(std::size_t iz0, std::size_t nz,
+	                 const std::vector<float> &slab, double weight);
 
 	QLength rmin, rmax, zmin, zmax;
 	QLength xmin, xmax, ymin, ymax;
 	int dimE;
+	/** Energy window to be loaded, the whole axis by default */
+	QEnergy Emin = QEnergy(0);
+	QEnergy Emax = QEnergy(std::numeric_limits<double>::infinity());
+	std::size_t iEmin; /**< First loaded bin of the file energy axis */
 	int dimx, dimy, dimz, dimr;
-	std::vector<std::unique_ptr<ScalarGridQPDensityPerEnergy>> grid;
-
-	// TODO: implement as std::unordered_map
-	std::map<QEnergy, std::size_t> energyIndex;
+	std::unique_ptr<SpectralGridQPDensityPerEnergy> grid;
 
   public:
 	Dragon3D();
 	Dragon3D(const std::string &filename_, const PID &pid_);
 	Dragon3D(const std::string &filename_, const std::vector<PID> &pids_);
+	/** Load only the energy window [Emin, Emax], widened by one bin on each
+	 * side; all selected species are summed into one grid. Gamma rays from
+	 * pi0 decay, bremsstrahlung and IC are never more energetic than the
+	 * parent particle, so for gamma-ray skymaps Emin can be the lowest
+	 * skymap energy (GammaSkymapRange::getEnergies) */
+	Dragon3D(const std::string &filename_, const std::vector<PID> &pids_,
+	         const QEnergy &Emin_,
+	         const QEnergy &Emax_ =
+	             QEnergy(std::numeric_limits<double>::infinity()));
+	/** Load the species in weights_, each multiplied with its weight, into
+	 * one grid; with the weights of
+	 * DifferentialCrossSection::getProjectileWeights the density is
+	 * projectile weighted */
+	Dragon3D(const std::string &filename_,
+	         const std::map<PID, double> &weights_,
+	         const QEnergy &Emin_ = QEnergy(0),
+	         const QEnergy &Emax_ =
+	             QEnergy(std::numeric_limits<double>::infinity()));
 	QPDensityPerEnergy getDensityPerEnergy(
 	    const QEnergy &E_, const Vector3QLength &pos_) const override;
-	QPDensityPerEnergy getDensityPerEnergy(int iE_,
-	                                       const Vector3QLength &pos_) const;
+	QPDensityPerEnergy getDensityPerEnergy(
+	    std::size_t iE_, const Vector3QLength &pos_) const override;
+	void getSpectrum(const Vector3QLength &pos_,
+	                 std::vector<QPDensityPerEnergy> &spectrum) const override;
 };
 
 /** @}*/
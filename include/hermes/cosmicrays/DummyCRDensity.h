@@ -20,6 +20,7 @@ class DummyCRDensity : public CosmicRayDensity {
 	DummyCRDensity(const PID &pid);
 	DummyCRDensity(const PID &pid, const QEnergy &minE, const QEnergy &maxE,
 	               int steps);
+	using CosmicRayDensity::getDensityPerEnergy;
 	QPDensityPerEnergy getDensityPerEnergy(
 	    const QEnergy &E_, const Vector3QLength &pos_) const override;
 };
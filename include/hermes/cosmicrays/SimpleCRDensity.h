@@ -18,8 +18,13 @@ class SimpleCRDensity : public CosmicRayDensity {
   public:
 	SimpleCRDensity(const PID &pid = Proton);
 	SimpleCRDensity(const PID &pid, QEnergy minE, QEnergy maxE, int steps);
+	using CosmicRayDensity::getDensityPerEnergy;
 	QPDensityPerEnergy getDensityPerEnergy(
 	    const QEnergy &E_, const Vector3QLength &pos_) const override;
+
+	bool isSeparable() const override { return true; }
+	QPDensityPerEnergy getSpectralShape(const QEnergy &E_) const override;
+	QNumber getSpatialProfile(const Vector3QLength &pos_) const override;
 };
 
 /** @}*/
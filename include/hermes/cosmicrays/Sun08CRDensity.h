@@ -23,8 +23,13 @@ class Sun08CRDensity : public CosmicRayDensity {
   public:
 	Sun08CRDensity();
 	Sun08CRDensity(QEnergy minE_, QEnergy maxE_, int steps_);
+	using CosmicRayDensity::getDensityPerEnergy;
 	QPDensityPerEnergy getDensityPerEnergy(
 	    const QEnergy &E_, const Vector3QLength &pos_) const override;
+
+	bool isSeparable() const override { return true; }
+	QPDensityPerEnergy getSpectralShape(const QEnergy &E_) const override;
+	QNumber getSpatialProfile(const Vector3QLength &pos_) const override;
 };
 
 /** @}*/
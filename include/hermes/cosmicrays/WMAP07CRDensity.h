@@ -23,8 +23,13 @@ class WMAP07CRDensity : public CosmicRayDensity {
   public:
 	WMAP07CRDensity();
 	WMAP07CRDensity(QEnergy minE_, QEnergy maxE_, int steps_);
+	using CosmicRayDensity::getDensityPerEnergy;
 	QPDensityPerEnergy getDensityPerEnergy(
 	    const QEnergy &E_, const Vector3QLength &pos_) const override;
+
+	bool isSeparable() const override { return true; }
+	QPDensityPerEnergy getSpectralShape(const QEnergy &E_) const override;
+	QNumber getSpatialProfile(const Vector3QLength &pos_) const override;
 };
 
 /** @}*/
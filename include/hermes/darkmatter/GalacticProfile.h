@@ -1,6 +1,8 @@
 #ifndef HERMES_DARKMATTER_GALACTICPROFILE_H
 #define HERMES_DARKMATTER_GALACTICPROFILE_H
 
+#include <vector>
+
 #include "hermes/Units.h"
 
 namespace hermes { namespace darkmatter {
@@ -16,6 +18,14 @@ class GalacticProfile {
 	GalacticProfile() {}
 	virtual ~GalacticProfile() {}
 	virtual QMassDensity getMassDensity(QLength r) const = 0;
+	/** Mass density at many radii with a single virtual call, densities is
+	 * resized to the number of radii */
+	virtual void getMassDensities(const std::vector<QLength> &r,
+	                              std::vector<QMassDensity> &densities) const {
+		densities.resize(r.size());
+		for (std::size_t i = 0; i < r.size(); ++i)
+			densities[i] = getMassDensity(r[i]);
+	}
 };
 
 /** @}*/
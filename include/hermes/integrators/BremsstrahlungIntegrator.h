@@ -18,6 +18,13 @@ class BremsstrahlungIntegrator : public PiZeroIntegrator {
   private:
 	std::shared_ptr<interactions::BremsstrahlungAbstract> crossSecBrem;
 
+	tEnergyKernel computeEnergyKernel(
+	    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+	    const QEnergy &Egamma) const override;
+	QPiZeroIntegral integrateOverEnergy(
+	    const Vector3QLength &pos, const QEnergy &Egamma,
+	    const tEnergyKernels &kernels) const override;
+
   public:
 	BremsstrahlungIntegrator(
 	    const std::shared_ptr<cosmicrays::CosmicRayDensity> &,
@@ -25,8 +32,7 @@ class BremsstrahlungIntegrator : public PiZeroIntegrator {
 	    const std::shared_ptr<interactions::BremsstrahlungAbstract> &);
 	~BremsstrahlungIntegrator();
 
-	QPiZeroIntegral integrateOverEnergy(const Vector3QLength &pos,
-	                                    const QEnergy &Egamma) const override;
+	using PiZeroIntegrator::integrateOverEnergy;
 };
 
 /** @}*/
@@ -3,6 +3,8 @@
 
 #include <array>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "hermes/CacheTools.h"
 #include "hermes/ProgressBar.h"
@@ -32,10 +34,51 @@ class InverseComptonIntegrator : public GammaIntegratorTemplate {
 	                          const QEnergy &Egamma,
 	                          std::shared_ptr<ProgressBar> &p);
 
+	/** Electron energy integral of separable CR models: the spectral
+	 * shape times the cross-section and the photon energy weights, one value
+	 * per photon energy of phdensity; built once per gamma-ray energy */
+	typedef decltype(QGREmissivity() / QEnergyDensity()) QICKernel;
+	typedef std::vector<QICKernel> tSeparableKernel;
+	ParameterCache<QEnergy, tSeparableKernel> separableKernel;
+	tSeparableKernel computeSeparableKernel(const QEnergy &Egamma) const;
+
+	/** Cross-section times the log-step weights of the photon energy
+	 * integral, in SI units: integrateOverPhotonEnergy() at the iE-th CR
+	 * energy is sum_j K[iE * nPhoton + j] u_j, for the energy densities u_j
+	 * of phdensity; built once per gamma-ray energy */
+	typedef std::vector<double> tKernelMatrix;
+	ParameterCache<QEnergy, tKernelMatrix> kernelMatrix;
+	tKernelMatrix computeKernelMatrix(const QEnergy &Egamma) const;
+
+	/** Photon energy integrals of the component spectra of a low-rank
+	 * photon field (see PhotonField::getNumberOfComponents()) at every CR
+	 * energy, [iE * nComponents + k]; built once per gamma-ray energy and
+	 * PhotonField::getComponentsVersion() */
+	typedef std::vector<QICInnerIntegral> tComponentKernel;
+	typedef std::pair<QEnergy, std::size_t> tComponentKey;
+	ParameterCache<tComponentKey, tComponentKernel> componentKernel;
+	tComponentKernel computeComponentKernel(const QEnergy &Egamma) const;
+
+	/** The kernels of one gamma-ray energy which the models need, looked
+	 * up once per LOS or cache thread instead of per LOS step */
+	struct tKernels {
+		std::shared_ptr<const tSeparableKernel> separable;
+		std::shared_ptr<const tKernelMatrix> matrix;
+		std::shared_ptr<const tComponentKernel> components;
+	};
+	tKernels getKernels(const QEnergy &Egamma) const;
+	QGREmissivity integrateOverEnergy(const Vector3QLength &pos,
+	                                  const QEnergy &Egamma,
+	                                  const tKernels &kernels) const;
+
+	/** integrateOverPhotonEnergy() at all CR energies at a position */
+	void integrateOverPhotonEnergies(
+	    const Vector3QLength &pos, const tKernels &kernels,
+	    std::vector<QICInnerIntegral> &integrals) const;
 	QGREmissivity integrateOverSumEnergy(const Vector3QLength &pos,
-	                                     const QEnergy &Egamma) const;
+	                                     const tKernels &kernels) const;
 	QGREmissivity integrateOverLogEnergy(const Vector3QLength &pos,
-	                                     const QEnergy &Egamma) const;
+	                                     const tKernels &kernels) const;
 
   public:
 	InverseComptonIntegrator(
@@ -55,6 +98,11 @@ class InverseComptonIntegrator : public GammaIntegratorTemplate {
 	QICInnerIntegral integrateOverPhotonEnergy(const Vector3QLength &pos,
 	                                           const QEnergy &Egamma,
 	                                           const QEnergy &Eelectron) const;
+	/** Same as above for a photon spectrum from PhotonField::getSpectrum(),
+	 * which is fetched once per position for all electron energies */
+	QICInnerIntegral integrateOverPhotonEnergy(
+	    const std::vector<QEnergyDensity> &photonSpectrum,
+	    const QEnergy &Egamma, const QEnergy &Eelectron) const;
 
 	void setupCacheTable(int N_x, int N_y, int N_z) override;
 	void initCacheTable() override;
@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 
+#include "hermes/CacheTools.h"
 #include "hermes/ProgressBar.h"
 #include "hermes/Units.h"
 #include "hermes/cosmicrays/CosmicRayDensity.h"
@@ -33,6 +34,32 @@ class PiZeroAbsorptionIntegrator : public GammaIntegratorTemplate {
 	typedef Grid<QPiZeroIntegral> ICCacheTable;
 	std::shared_ptr<ICCacheTable> cacheTable;
 
+	/** E * dsigma/dE(E, Egamma) * c at the CR energies above Egamma of an
+	 * energy axis, computed once per gamma-ray energy for all distinct
+	 * energy axes of crList */
+	typedef decltype(QDiffCrossSection() * QEnergy() * QSpeed()) QPiZeroKernel;
+	typedef std::vector<QPiZeroKernel> tEnergyKernel;
+	typedef std::vector<tEnergyKernel> tEnergyKernels;
+	ParameterCache<QEnergy, tEnergyKernels> energyKernels;
+	/** Index of the kernel of every density of crList, densities with the
+	 * same energy axis share one; the first density of every axis */
+	std::vector<std::size_t> kernelIndex;
+	std::vector<std::shared_ptr<cosmicrays::CosmicRayDensity>> kernelAxes;
+	void indexEnergyAxes();
+	tEnergyKernel computeEnergyKernel(
+	    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+	    const QEnergy &Egamma) const;
+	/** The kernels are looked up once per LOS or cache thread */
+	std::shared_ptr<const tEnergyKernels> getEnergyKernels(
+	    const QEnergy &Egamma) const;
+	QPiZeroIntegral integrateOverEnergy(const Vector3QLength &pos,
+	                                    const QEnergy &Egamma,
+	                                    const tEnergyKernels &kernels) const;
+
+	/** Throws if a projectile-weighted density in crList was weighted
+	 * for another cross-section or other gas abundances */
+	void checkProjectileWeights() const;
+
 	QPiZeroIntegral getIOEfromCache(const Vector3QLength &,
 	                                const QEnergy &) const;
 	void computeCacheInThread(std::size_t start, std::size_t end,
@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 
+#include "hermes/CacheTools.h"
 #include "hermes/ProgressBar.h"
 #include "hermes/Units.h"
 #include "hermes/cosmicrays/CosmicRayDensity.h"
@@ -31,6 +32,38 @@ class PiZeroIntegrator : public GammaIntegratorTemplate {
 	typedef Grid<QPiZeroIntegral> tCacheTable;
 	std::shared_ptr<tCacheTable> cacheTable;
 
+	/** E * dsigma/dE(E, Egamma) * c at the CR energies above Egamma of an
+	 * energy axis; the log-integration over energy is a dot product of it
+	 * with the spectrum. The kernels of all distinct energy axes of crList
+	 * are computed once per gamma-ray energy */
+	typedef decltype(QDiffCrossSection() * QEnergy() * QSpeed()) QPiZeroKernel;
+	typedef std::vector<QPiZeroKernel> tEnergyKernel;
+	typedef std::vector<tEnergyKernel> tEnergyKernels;
+	ParameterCache<QEnergy, tEnergyKernels> energyKernels;
+	/** Index of the kernel of every density of crList, densities with the
+	 * same energy axis share one; the first density of every axis */
+	std::vector<std::size_t> kernelIndex;
+	std::vector<std::shared_ptr<cosmicrays::CosmicRayDensity>> kernelAxes;
+	void indexEnergyAxes();
+	virtual tEnergyKernel computeEnergyKernel(
+	    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+	    const QEnergy &Egamma) const;
+	/** The kernels are looked up once per LOS or cache thread and passed
+	 * down by reference, not per LOS step */
+	std::shared_ptr<const tEnergyKernels> getEnergyKernels(
+	    const QEnergy &Egamma) const;
+	virtual QPiZeroIntegral integrateOverEnergy(
+	    const Vector3QLength &pos, const QEnergy &Egamma,
+	    const tEnergyKernels &kernels) const;
+	QPiZeroIntegral integrateSpectrum(
+	    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+	    const Vector3QLength &pos, const QEnergy &Egamma,
+	    const tEnergyKernel &kernel) const;
+
+	/** Throws if a projectile-weighted density in crList was weighted
+	 * for another cross-section or other gas abundances */
+	void checkProjectileWeights() const;
+
 	QPiZeroIntegral getIOEfromCache(const Vector3QLength &,
 	                                const QEnergy &) const;
 	void computeCacheInThread(std::size_t start, std::size_t end,
@@ -55,8 +88,8 @@ class PiZeroIntegrator : public GammaIntegratorTemplate {
 	QDiffIntensity integrateOverLOS(const QDirection &iterdir,
 	                                const QEnergy &Egamma) const override;
 
-	virtual QPiZeroIntegral integrateOverEnergy(const Vector3QLength &pos,
-	                                            const QEnergy &Egamma) const;
+	QPiZeroIntegral integrateOverEnergy(const Vector3QLength &pos,
+	                                    const QEnergy &Egamma) const;
 
 	void setupCacheTable(int, int, int) override;
 	void initCacheTable() override;
@@ -29,10 +29,19 @@ namespace hermes {
  */
 class RotationMeasureIntegrator
     : public IntegratorTemplate<QRotationMeasure, QNumber> {
-  private:
+  protected:
 	std::shared_ptr<magneticfields::MagneticField> mfield;
 	std::shared_ptr<chargedgas::ChargedGasDensity> gdensity;
 
+	typedef decltype(QRMIntegral() / (QMField() * QPDensity() * radian))
+	    QRMConstant;
+	const QRMConstant const_rm =
+	    pow<3>(e_plus) /
+	    (8 * pi * pi * epsilon0 * squared(m_electron) * pow<3>(c_light));
+
+	/** Component of B parallel to the LOS towards pos */
+	QMField getParallelField(const Vector3QMField& B,
+	                         const Vector3QLength& pos) const;
 	QRMIntegral integralFunction(const Vector3QLength& pos) const;
 
   public:
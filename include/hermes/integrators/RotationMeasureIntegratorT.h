@@ -0,0 +1,83 @@
+#ifndef HERMES_RMINTEGRATORT_H
+#define HERMES_RMINTEGRATORT_H
+
+#include <memory>
+
+#include "hermes/Units.h"
+#include "hermes/chargedgas/YMW16.h"
+#include "hermes/integrators/LOSIntegrationMethods.h"
+#include "hermes/integrators/RotationMeasureIntegrator.h"
+#include "hermes/magneticfields/JF12.h"
+
+/** \file RotationMeasureIntegratorT.h
+ *  Declares RotationMeasureIntegratorT
+ */
+
+namespace hermes {
+/**
+ * \addtogroup Integrators
+ * @{
+ */
+
+/**
+ * \class RotationMeasureIntegratorT
+ * \brief RotationMeasureIntegrator with the model types fixed at compile time
+ *
+ * FIELD and GAS have to be concrete model classes, for example
+ * magneticfields::JF12 and chargedgas::YMW16. Their getField() and
+ * getDensity() are called qualified, so the per-sample kernel contains no
+ * virtual calls and the compiler is free to inline the models.
+ *
+ * The qualified calls always run FIELD::getField() and GAS::getDensity():
+ * an object of a class derived from FIELD or GAS is evaluated as FIELD or
+ * GAS, its overrides are bypassed. Instantiate the template with the most
+ * derived class instead.
+ *
+ * RotationMeasureIntegratorJF12YMW16 is instantiated inside the library,
+ * where release builds with link-time optimisation inline JF12 and YMW16
+ * into the kernel; other instantiations live in the user's translation
+ * unit and only inline what is visible there.
+ */
+template <typename FIELD, typename GAS>
+class RotationMeasureIntegratorT : public RotationMeasureIntegrator {
+  private:
+	std::shared_ptr<FIELD> mfieldT;
+	std::shared_ptr<GAS> gdensityT;
+
+	QRMIntegral integralFunction(const Vector3QLength &pos) const {
+		Vector3QMField B = mfieldT->FIELD::getField(pos);
+		if (B.getR() == 0_muG) return 0;
+
+		return const_rm * getParallelField(B, pos) *
+		       gdensityT->GAS::getDensity(pos) * radian;
+	}
+
+  public:
+	RotationMeasureIntegratorT(const std::shared_ptr<FIELD> &mfield_,
+	                           const std::shared_ptr<GAS> &gdensity_)
+	    : RotationMeasureIntegrator(mfield_, gdensity_),
+	      mfieldT(mfield_),
+	      gdensityT(gdensity_) {}
+
+	using RotationMeasureIntegrator::integrateOverLOS;
+	QRotationMeasure integrateOverLOS(
+	    const QDirection &direction) const override {
+		auto integrand = [this, &direction](const QLength &dist) {
+			return this->integralFunction(
+			    getGalacticPosition(getSunPosition(), dist, direction));
+		};
+
+		return simpsonIntegration<QRotationMeasure, QRMIntegral>(
+		    integrand, 0, getMaxDistance(direction), 500);
+	}
+};
+
+typedef RotationMeasureIntegratorT<magneticfields::JF12, chargedgas::YMW16>
+    RotationMeasureIntegratorJF12YMW16;
+extern template class RotationMeasureIntegratorT<magneticfields::JF12,
+                                                 chargedgas::YMW16>;
+
+/** @}*/
+}  // namespace hermes
+
+#endif  // HERMES_RMINTEGRATORT_H
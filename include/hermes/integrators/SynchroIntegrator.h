@@ -3,7 +3,9 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
+#include "hermes/CacheTools.h"
 #include "hermes/Units.h"
 #include "hermes/cosmicrays/CosmicRayDensity.h"
 #include "hermes/integrators/IntegratorTemplate.h"
@@ -27,17 +29,45 @@ namespace hermes {
  * magneticfields::JF12 and cosmic ray lepton distribution
  */
 class SynchroIntegrator : public RadioIntegratorTemplate {
-  private:
+  protected:
 	std::shared_ptr<magneticfields::MagneticField> mfield;
 	std::shared_ptr<cosmicrays::CosmicRayDensity> crdensity;
 	const QSynchroConstant const_synchro =
 	    std::sqrt(3) * pow<3>(e_plus) /
 	    (8 * pi * pi * epsilon0 * c_light * m_electron);
 
-	QEmissivity integrateOverSumEnergy(const Vector3QLength &pos,
-	                                   const QFrequency &freq) const;
-	QEmissivity integrateOverLogEnergy(const Vector3QLength &pos,
-	                                   const QFrequency &freq) const;
+	/** Emissivity of separable CR models per unit of their spatial
+	 * profile, tabulated in log(B_perp) for one frequency at a time */
+	typedef std::vector<QEmissivity> tSeparableTable;
+	bool useSeparableTable;
+	ParameterCache<QFrequency, tSeparableTable> separableTable;
+	tSeparableTable computeSeparableTable(const QFrequency &freq) const;
+	QEmissivity integrateOverSpectralShape(const QMField &B_perp,
+	                                       const QFrequency &freq) const;
+	/** Table for freq, nullptr if crdensity is not separable or the
+	 * table is disabled; resolved once per LOS */
+	std::shared_ptr<const tSeparableTable> getSeparableTable(
+	    const QFrequency &freq) const;
+	QEmissivity interpolateSeparableTable(const tSeparableTable &table,
+	                                      const QMField &B_perp,
+	                                      const QFrequency &freq) const;
+	/** integrateOverEnergy() with an already resolved table */
+	QEmissivity integrateOverEnergy(const Vector3QLength &pos,
+	                                const QFrequency &freq,
+	                                const tSeparableTable *table) const;
+
+	/** Component of B perpendicular to the LOS towards pos, zero for a null
+	 * field and at the origin */
+	QMField getPerpendicularField(const Vector3QMField &B,
+	                              const Vector3QLength &pos) const;
+
+	/** Energy integrals over a spectrum on the energy axis of crdensity */
+	QEmissivity integrateOverSumEnergy(
+	    const std::vector<QPDensityPerEnergy> &spectrum,
+	    const QMField &B_perp, const QFrequency &freq) const;
+	QEmissivity integrateOverLogEnergy(
+	    const std::vector<QPDensityPerEnergy> &spectrum,
+	    const QMField &B_perp, const QFrequency &freq) const;
 
   public:
 	SynchroIntegrator(
@@ -48,6 +78,12 @@ class SynchroIntegrator : public RadioIntegratorTemplate {
 	void setFrequency(const QFrequency &freq);
 	QFrequency getFrequency() const;
 
+	/** The B_perp table of separable CR models is interpolated to a
+	 * relative accuracy of 1e-4; setUseSeparableTable(false) integrates
+	 * over the energy axis at every position instead */
+	void setUseSeparableTable(bool use);
+	bool isUsingSeparableTable() const;
+
 	QTemperature integrateOverLOS(const QDirection &iterdir) const override;
 	QTemperature integrateOverLOS(const QDirection &iterdir,
 	                              const QFrequency &freq) const override;
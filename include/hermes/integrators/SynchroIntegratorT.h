@@ -0,0 +1,121 @@
+#ifndef HERMES_SYNCHROINTEGRATORT_H
+#define HERMES_SYNCHROINTEGRATORT_H
+
+#include <memory>
+#include <vector>
+
+#include "hermes/Common.h"
+#include "hermes/Units.h"
+#include "hermes/cosmicrays/Dragon2D.h"
+#include "hermes/integrators/LOSIntegrationMethods.h"
+#include "hermes/integrators/SynchroIntegrator.h"
+#include "hermes/magneticfields/JF12.h"
+
+/** \file SynchroIntegratorT.h
+ *  Declares SynchroIntegratorT
+ */
+
+namespace hermes {
+/**
+ * \addtogroup Integrators
+ * @{
+ */
+
+/**
+ * \class SynchroIntegratorT
+ * \brief SynchroIntegrator with the model types fixed at compile time
+ *
+ * FIELD and CR have to be concrete model classes, for example
+ * magneticfields::JF12 and cosmicrays::Dragon2D. The field and the CR
+ * spectrum are obtained with qualified calls, so the per-sample kernel is
+ * statically dispatched and can be inlined; the energy integrals are the
+ * ones of SynchroIntegrator.
+ *
+ * The qualified calls always run the FIELD and CR implementations: an
+ * object of a class derived from FIELD or CR is evaluated as FIELD or CR,
+ * its overrides are bypassed. Instantiate the template with the most
+ * derived class instead.
+ *
+ * SynchroIntegratorJF12Dragon2D is instantiated inside the library, where
+ * release builds with link-time optimisation inline JF12 and Dragon2D into
+ * the kernel; other instantiations live in the user's translation unit and
+ * only inline what is visible there.
+ */
+template <typename FIELD, typename CR>
+class SynchroIntegratorT : public SynchroIntegrator {
+  private:
+	std::shared_ptr<FIELD> mfieldT;
+	std::shared_ptr<CR> crdensityT;
+
+  public:
+	SynchroIntegratorT(const std::shared_ptr<FIELD> &mfield_,
+	                   const std::shared_ptr<CR> &crdensity_)
+	    : SynchroIntegrator(mfield_, crdensity_),
+	      mfieldT(mfield_),
+	      crdensityT(crdensity_) {}
+
+	using SynchroIntegrator::integrateOverLOS;
+	QTemperature integrateOverLOS(const QDirection &direction,
+	                              const QFrequency &freq_) const override {
+		auto table = getSeparableTable(freq_);
+		auto integrand = [this, &direction, &freq_,
+		                  &table](const QLength &dist) {
+			return this->integrateOverEnergy(
+			    getGalacticPosition(this->positionSun, dist, direction),
+			    freq_, table.get());
+		};
+
+		QIntensity total_intensity =
+		    simpsonIntegration<QIntensity, QEmissivity>(
+		        integrand, 0, getMaxDistance(direction), 100);
+
+		return intensityToTemperature(total_intensity / 4_pi, freq_);
+	}
+
+	QEmissivity integrateOverEnergy(const Vector3QLength &pos_,
+	                                const QFrequency &freq_) const {
+		return integrateOverEnergy(pos_, freq_,
+		                           getSeparableTable(freq_).get());
+	}
+
+  protected:
+	QEmissivity integrateOverEnergy(const Vector3QLength &pos_,
+	                                const QFrequency &freq_,
+	                                const tSeparableTable *table) const {
+		if (table != nullptr) {
+			QNumber profile = crdensityT->CR::getSpatialProfile(pos_);
+			if (profile == QNumber(0)) return QEmissivity(0);
+
+			QMField B_perp =
+			    getPerpendicularField(mfieldT->FIELD::getField(pos_), pos_);
+			if (B_perp == 0_T) return QEmissivity(0);
+			return profile *
+			       interpolateSeparableTable(*table, B_perp, freq_);
+		}
+
+		QMField B_perp =
+		    getPerpendicularField(mfieldT->FIELD::getField(pos_), pos_);
+		if (B_perp == 0_T) return QEmissivity(0);
+
+		// per-thread scratch buffer, it keeps its capacity between calls
+		thread_local std::vector<QPDensityPerEnergy> spectrum;
+		crdensityT->CR::getSpectrum(pos_, spectrum);
+		if (crdensityT->existsScaleFactor()) {
+			return integrateOverLogEnergy(spectrum, B_perp, freq_);
+		} else {
+			return integrateOverSumEnergy(spectrum, B_perp, freq_);
+		}
+	}
+};
+
+#ifdef HERMES_HAVE_CFITSIO
+typedef SynchroIntegratorT<magneticfields::JF12, cosmicrays::Dragon2D>
+    SynchroIntegratorJF12Dragon2D;
+extern template class SynchroIntegratorT<magneticfields::JF12,
+                                         cosmicrays::Dragon2D>;
+#endif  // HERMES_HAVE_CFITSIO
+
+/** @}*/
+}  // namespace hermes
+
+#endif  // HERMES_SYNCHROINTEGRATORT_H
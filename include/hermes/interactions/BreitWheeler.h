@@ -11,10 +11,29 @@ namespace hermes { namespace interactions {
  * @{
  */
 
+/**
+ @class BreitWheeler
+ @brief Pair production cross-section of a gamma ray on a background photon
+
+ integratedOverTheta() depends on the energies only through
+ chi = Egamma Eph / (2 m_e^2 c^4). By default it is interpolated from a
+ table of ln(integral) at values of chi - 1/2 that are logarithmically
+ spaced between 1e-6 and 1e12 (100 per decade), which is built once per
+ process on first use. The interpolation agrees with the numerical
+ integration to better than 1e-4 (relative). Outside of this range,
+ or when the table is disabled with setUseTable(false), the integral
+ over theta is computed directly.
+ */
 class BreitWheeler {
+  private:
+	bool useTable;
+
   public:
 	BreitWheeler();
 
+	void setUseTable(bool use) { useTable = use; }
+	bool isUsingTable() const { return useTable; }
+
 	QArea getCrossSection(const QEnergy &Egamma, const QEnergy &Eph,
 	                      const QAngle &theta) const;
 	QArea integratedOverTheta(const QEnergy &Egamma, const QEnergy &Eph) const;
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "hermes/CacheTools.h"
 #include "hermes/interactions/BremsstrahlungAbstract.h"
@@ -13,11 +14,53 @@ namespace hermes { namespace interactions {
  * @{
  */
 
+/**
+ @class BremsstrahlungGALPROP
+ @brief Bremsstrahlung cross-sections as in GALPROP (Koch and Motz, 1959)
+
+ The high-energy regime needs nested numerical integrations. The
+ constructor therefore tabulates ln(dsigma/dE_gamma) per target on a dense
+ grid in ln(T_electron) and ln(E_gamma / (T_electron - E_gamma)), for
+ T_electron from 0.01 MeV to 1 PeV; the second variable resolves both the
+ power law at E_gamma << T_electron and the kinematic edge at
+ E_gamma -> T_electron. The grid in T_electron has a node on either side
+ of the boundaries between the energy regimes, so the interpolation never
+ crosses a discontinuity. A lookup is a bilinear interpolation in these
+ logarithms and costs the same at every energy; the relative error is
+ below 1e-3. Outside of the table, and next to nodes whose integrals did
+ not converge, the cross-section is computed directly.
+
+ The table is read-only after construction, so concurrent lookups need no
+ locks. It takes precedence over the cache of enableCaching(), which
+ keeps the exact values of the previous requests; disableTable() returns
+ to the exact cross-sections.
+ */
 class BremsstrahlungGALPROP : public BremsstrahlungAbstract {
   private:
 	bool cachingEnabled;
 	std::array<std::unique_ptr<CacheStorageCrossSection>, Ntargets> cache;
 
+	struct tTable {
+		// ln(T_electron / J) at the nodes, duplicated at the regime
+		// boundaries
+		std::vector<double> lnT;
+		// nodes in s = ln(E_gamma / (T_electron - E_gamma))
+		double sMin, sStep;
+		std::size_t nS;
+		// ln(dsigma/dE_gamma / (m^2/J)) per target, nS values per T node
+		std::array<std::vector<double>, Ntargets> values;
+	};
+
+	bool tableEnabled;
+	std::unique_ptr<tTable> table;
+
+	/** Fills the rows of all targets in parallel, with the GSL error
+	 * handler switched off */
+	std::unique_ptr<tTable> buildTable() const;
+	bool interpolateTable(Target t, const QEnergy &T_electron,
+	                      const QEnergy &E_gamma,
+	                      QDiffCrossSection &result) const;
+
 	QNumber ElwertFactor(const QNumber &beta_i, const QNumber &beta_f,
 	                     int Z) const;
 	QNumber xiFunc(const QNumber &T_electron_i, const QNumber &k, int Z,
@@ -52,6 +95,11 @@ class BremsstrahlungGALPROP : public BremsstrahlungAbstract {
 	void enableCaching();
 	void disableCaching();
 
+	/** Uses the table for all further requests (the default) */
+	void enableTable();
+	void disableTable();
+	bool isTableEnabled() const;
+
 	QDiffCrossSection getDiffCrossSectionForTarget(
 	    Target t, const QEnergy &T_electron,
 	    const QEnergy &E_gamma) const override;
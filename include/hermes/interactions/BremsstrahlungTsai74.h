@@ -1,6 +1,8 @@
 #ifndef HERMES_BREMSSTRAHLUNGTSAI74_H
 #define HERMES_BREMSSTRAHLUNGTSAI74_H
 
+#include <array>
+
 #include "hermes/interactions/BremsstrahlungAbstract.h"
 
 namespace hermes { namespace interactions {
@@ -9,9 +11,20 @@ namespace hermes { namespace interactions {
  * @{
  */
 
-// Rev. Mod. Phys. 46, 815 (1974).
+/**
+ @class BremsstrahlungTsai74
+ @brief Bremsstrahlung cross-sections of Tsai, Rev. Mod. Phys. 46, 815 (1974)
+
+ The cross-section depends on the energies only through
+ y = E_gamma / E_electron; the Coulomb correction and the radiation
+ logarithms of a target are computed once in the constructor, so an
+ evaluation costs the same at every energy and needs no table.
+ */
 class BremsstrahlungTsai74 : public BremsstrahlungAbstract {
   private:
+	// Z^2 (F_el - f) + Z F_inel and (Z^2 + Z) / 3 per target
+	std::array<double, Ntargets> screening, X2Factor;
+
 	std::pair<double, double> RadiationLogarithms(int Z) const;
 	double computeCoulombCorrection(int Z, std::size_t n_max = 100) const;
 
@@ -1,6 +1,10 @@
 #ifndef HERMES_DIFFERENTIALCROSSSECTION_H
 #define HERMES_DIFFERENTIALCROSSSECTION_H
 
+#include <map>
+#include <utility>
+#include <vector>
+
 #include "hermes/ParticleID.h"
 #include "hermes/Units.h"
 
@@ -29,6 +33,18 @@ class DifferentialCrossSection {
 	                                              const QEnergy &E_photon,
 	                                              const QEnergy &E_gamma) const;
 	virtual QNumber getSigma(const PID &projectile, const PID &target) const;
+	/** Weight sum_t f_t * getSigma(p, t) of each projectile p over the
+	 * targets t with abundance fractions f_t, e.g. the weights of a
+	 * pre-weighted multi-species CR density for pi0 production */
+	std::map<PID, double> getProjectileWeights(
+	    const std::vector<PID> &projectiles,
+	    const std::vector<std::pair<PID, double>> &targets) const;
+	/** Throws std::runtime_error if weights differ from
+	 * getProjectileWeights() for the same projectiles and targets, i.e. a
+	 * density was weighted for another cross-section or gas model */
+	void checkProjectileWeights(
+	    const std::map<PID, double> &weights,
+	    const std::vector<std::pair<PID, double>> &targets) const;
 };
 
 /** @}*/
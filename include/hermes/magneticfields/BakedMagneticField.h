@@ -0,0 +1,110 @@
+#ifndef HERMES_BAKEDMAGNETICFIELD_H
+#define HERMES_BAKEDMAGNETICFIELD_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "hermes/BakedGrid.h"
+#include "hermes/Grid.h"
+#include "hermes/Units.h"
+#include "hermes/magneticfields/JF12.h"
+#include "hermes/magneticfields/MagneticField.h"
+
+namespace hermes { namespace magneticfields {
+/**
+ * \addtogroup MagneticFields
+ * @{
+ */
+
+/**
+ @class BakedMagneticField
+ @brief Any MagneticField sampled on a VectorQMFieldGrid and trilinearly
+ interpolated
+
+ The grid is uniform and used between its first and last grid planes,
+ positions outside of it are passed to the baked model. For JF12, also when
+ it is passed as a MagneticField, only the smooth parts are baked, i.e. the
+ regular field and the Brms profile of the turbulent field; the random
+ striated and turbulent grids (or turbulent modes) of the model are kept
+ and combined with them in getField(), in the same way as JF12 does.
+ */
+class BakedMagneticField : public MagneticField {
+  public:
+	/** Evaluates a field at all positions at once, fields is resized to
+	 * positions.size() */
+	typedef std::function<void(const std::vector<Vector3QLength> &positions,
+	                           std::vector<Vector3QMField> &fields)>
+	    BatchFunction;
+
+  private:
+	std::shared_ptr<MagneticField> model;
+	std::shared_ptr<VectorQMFieldGrid> grid;
+	Vector3d lower, upper; /**< First and last grid planes */
+	Vector3d invSpacing;
+	QMField maxError, maxField;
+
+	// random JF12 components, combined lazily with the baked grids
+	std::shared_ptr<ScalarGrid> striatedGrid;
+	std::shared_ptr<VectorGrid> turbulentGrid;
+	std::shared_ptr<PlaneWaveTurbulence> turbulentModes;
+	std::shared_ptr<BakedGrid> turbulentStrength;
+	double sqrtbeta;
+
+	void initGrid(const Vector3QLength &origin, size_t Nx, size_t Ny,
+	              size_t Nz, const Vector3QLength &spacing);
+	/** Bake the smooth parts of JF12 and keep its random components */
+	void bakeJF12(const std::shared_ptr<JF12> &jf12,
+	              const Vector3QLength &origin, size_t Nx, size_t Ny,
+	              size_t Nz, const Vector3QLength &spacing,
+	              std::size_t validationPoints);
+	/** Sample f at all grid points, parallel over the z columns */
+	void bake(const BatchFunction &f);
+	void validate(const BatchFunction &f, std::size_t validationPoints);
+	bool isInside(const Vector3d &pos) const;
+	/** Trilinear interpolation of the grid, for isInside() positions */
+	Vector3QMField interpolate(const Vector3d &pos) const;
+
+  public:
+	/** Sample the model, through its getFields(), on a uniform grid; a
+	 * JF12 model is baked as by the JF12 overload
+	 @param	model	Field to bake, has to be thread safe
+	 @param	origin	Position of the lower left front corner of the volume
+	 @param	Nx		Number of grid points in x-direction
+	 @param	Ny		Number of grid points in y-direction
+	 @param	Nz		Number of grid points in z-direction
+	 @param spacing	Spacing vector between grid points
+	 @param validationPoints	Number of random positions at which the
+	 interpolation error is measured
+	 */
+	BakedMagneticField(const std::shared_ptr<MagneticField> &model,
+	                   const Vector3QLength &origin, size_t Nx, size_t Ny,
+	                   size_t Nz, const Vector3QLength &spacing,
+	                   std::size_t validationPoints = 10000);
+	/** Bake the regular field and the turbulent Brms of JF12 and keep its
+	 * striated and turbulent grids; the components in use at construction
+	 * are the ones served by getField() */
+	BakedMagneticField(const std::shared_ptr<JF12> &model,
+	                   const Vector3QLength &origin, size_t Nx, size_t Ny,
+	                   size_t Nz, const Vector3QLength &spacing,
+	                   std::size_t validationPoints = 10000);
+
+	Vector3QMField getField(const Vector3QLength &pos) const override;
+	void getFields(const std::vector<Vector3QLength> &positions,
+	               std::vector<Vector3QMField> &fields) const override;
+
+	/** True between the first and the last grid planes of every axis */
+	bool isInside(const Vector3QLength &pos) const;
+	/** Largest interpolation error of the baked (regular) field found at the
+	 * validation points */
+	QMField getMaxError() const { return maxError; }
+	/** Largest field strength of the model at the validation points */
+	QMField getMaxField() const { return maxField; }
+
+	std::shared_ptr<VectorQMFieldGrid> getGrid() const { return grid; }
+};
+
+/** @} */
+}}  // namespace hermes::magneticfields
+
+#endif  // HERMES_BAKEDMAGNETICFIELD_H
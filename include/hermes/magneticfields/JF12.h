@@ -7,6 +7,7 @@
 #include "hermes/GridTools.h"
 #include "hermes/Units.h"
 #include "hermes/magneticfields/MagneticField.h"
+#include "hermes/magneticfields/PlaneWaveTurbulence.h"
 
 namespace hermes { namespace magneticfields {
 /**
@@ -67,6 +68,7 @@ class JF12 : public MagneticField {
 	// Turbulent field
 	// --------------------------------------------------------
 	std::shared_ptr<VectorGrid> turbulentGrid;
+	std::shared_ptr<PlaneWaveTurbulence> turbulentModes;
 	// disk
 	QMField bDiskTurb[8];  // field strengths in arms at r=5 kpc
 	QMField bDiskTurb5;    // field strength at r<5kpc
@@ -79,12 +81,22 @@ class JF12 : public MagneticField {
   public:
 	JF12();
 
+	/** Galactocentric position in the coordinates used by the components
+	 * below */
+	static Vector3QLength toModelCoordinates(const Vector3QLength &pos);
+
 	// Create and set a random realization for the striated field
 	void randomStriated(int seed = 0);
 
 #ifdef HERMES_HAVE_FFTW3F
-	// Create a random realization for the turbulent field
-	void randomTurbulent(int seed = 0);
+	/**
+	 * Create a random realization for the turbulent field
+	 * @param seed	random seed, 0 for a random one
+	 * @param N		number of grid points per axis, the grid spacing is
+	 * 4 parsec and N has to be at least 136 (272 parsec, twice the largest
+	 * wavelength)
+	 */
+	void randomTurbulent(int seed = 0, size_t N = 256);
 #endif
 
 	/**
@@ -100,8 +112,18 @@ class JF12 : public MagneticField {
 	 */
 	void setTurbulentGrid(std::shared_ptr<VectorGrid> grid);
 
+	/**
+	 * Use a grid-free turbulent field instead of a grid and activate the
+	 * turbulent field component; its getUnitField() is modulated with
+	 * getTurbulentStrength()
+	 */
+	void setTurbulentModes(std::shared_ptr<PlaneWaveTurbulence> modes);
+
 	std::shared_ptr<ScalarGrid> getStriatedGrid();
 	std::shared_ptr<VectorGrid> getTurbulentGrid();
+	std::shared_ptr<PlaneWaveTurbulence> getTurbulentModes();
+	/** Relative strength of the striated field, sqrt(beta) */
+	double getStriatedStrength() const { return sqrtbeta; }
 
 	void setUseRegular(bool use);
 	void setUseStriated(bool use);
@@ -125,6 +147,8 @@ class JF12 : public MagneticField {
 
 	// All set field components
 	Vector3QMField getField(const Vector3QLength &pos) const override;
+	void getFields(const std::vector<Vector3QLength> &positions,
+	               std::vector<Vector3QMField> &fields) const override;
 };
 
 /** @} */
@@ -2,6 +2,7 @@
 #define HERMES_MAGNETICFIELD_H
 
 #include <memory>
+#include <vector>
 
 #include "hermes/Units.h"
 #include "hermes/Vector3.h"
@@ -27,6 +28,15 @@ class MagneticField {
 	virtual Vector3QMField getField(const Vector3QLength &position) const {
 		return Vector3QMField(0_muG);
 	};
+	/** Field at many positions with a single virtual call, fields is
+	 * resized to the number of positions; models override it with a loop
+	 * free of virtual dispatch */
+	virtual void getFields(const std::vector<Vector3QLength> &positions,
+	                       std::vector<Vector3QMField> &fields) const {
+		fields.resize(positions.size());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			fields[i] = getField(positions[i]);
+	}
 };
 
 /**
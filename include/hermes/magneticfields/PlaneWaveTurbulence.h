@@ -0,0 +1,65 @@
+#ifndef HERMES_PLANEWAVETURBULENCE_H
+#define HERMES_PLANEWAVETURBULENCE_H
+
+#include <vector>
+
+#include "hermes/Units.h"
+#include "hermes/magneticfields/MagneticField.h"
+
+namespace hermes { namespace magneticfields {
+/**
+ * \addtogroup MagneticFields
+ * @{
+ */
+
+/**
+ @class PlaneWaveTurbulence
+ @brief Grid-free turbulent field, a sum of random plane waves
+
+ B(x) = sqrt(2) sum_n A_n xi_n cos(k_n kappa_n . x + beta_n) with nModes
+ wave numbers k_n logarithmically spaced between 2 pi / lMax and 2 pi / lMin,
+ isotropic random directions kappa_n, random polarisations xi_n perpendicular
+ to kappa_n (divergence free) and random phases beta_n. The amplitudes follow
+ <B^2(k)> ~ k^alpha, as in initTurbulence(), and are normalised to Brms.
+
+ The field does not repeat and needs no memory besides the modes; the cost
+ of an evaluation grows linearly with nModes. The modes are kept as plain
+ arrays, so the mode sum is vectorised by the compiler (cos() needs
+ -ffast-math, which is part of the release flags).
+ */
+class PlaneWaveTurbulence : public MagneticField {
+  private:
+	QMField Brms;
+	// modes: wave vectors (1/m), polarisations times amplitudes for
+	// Brms = 1, phases
+	std::vector<double> kx, ky, kz, ax, ay, az, phase;
+
+  public:
+	/**
+	 @param Brms	RMS field strength
+	 @param lMin	Minimum wavelength of the turbulence
+	 @param lMax	Maximum wavelength of the turbulence
+	 @param nModes	Number of plane waves
+	 @param seed	Random seed, 0 for a random one
+	 @param alpha	Power law index of <B^2(k)> ~ k^alpha (alpha = -11/3
+	 corresponds to a Kolmogorov spectrum)
+	 */
+	PlaneWaveTurbulence(const QMField &Brms, const QLength &lMin,
+	                    const QLength &lMax, int nModes = 1000, int seed = 0,
+	                    double alpha = -11. / 3.);
+
+	/** Field for Brms = 1, e.g. to be modulated by a Brms profile */
+	Vector3d getUnitField(const Vector3QLength &pos) const;
+
+	Vector3QMField getField(const Vector3QLength &pos) const override;
+	void getFields(const std::vector<Vector3QLength> &positions,
+	               std::vector<Vector3QMField> &fields) const override;
+
+	QMField getBrms() const { return Brms; }
+	std::size_t getNumberOfModes() const { return phase.size(); }
+};
+
+/** @} */
+}}  // namespace hermes::magneticfields
+
+#endif  // HERMES_PLANEWAVETURBULENCE_H
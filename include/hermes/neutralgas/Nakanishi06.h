@@ -19,6 +19,9 @@ class Nakanishi06 : public ProfileAbstract {
 	QPDensity getH2Density(const Vector3QLength &pos) const;
 	QPDensity getPDensity(GasType gas,
 	                      const Vector3QLength &pos) const override;
+	void getPDensities(GasType gas,
+	                   const std::vector<Vector3QLength> &positions,
+	                   std::vector<QPDensity> &densities) const override;
 };
 
 /** @}*/
@@ -1,6 +1,8 @@
 #ifndef HERMES_NEUTRALGAS_PROFILEABSTRACT_H
 #define HERMES_NEUTRALGAS_PROFILEABSTRACT_H
 
+#include <vector>
+
 #include "hermes/Units.h"
 #include "hermes/Vector3Quantity.h"
 #include "hermes/neutralgas/GasType.h"
@@ -20,6 +22,15 @@ class ProfileAbstract {
 
 	virtual QPDensity getPDensity(GasType gas,
 	                              const Vector3QLength &pos) const = 0;
+	/** Density at many positions with a single virtual call, densities is
+	 * resized to the number of positions */
+	virtual void getPDensities(GasType gas,
+	                           const std::vector<Vector3QLength> &positions,
+	                           std::vector<QPDensity> &densities) const {
+		densities.resize(positions.size());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			densities[i] = getPDensity(gas, positions[i]);
+	}
 };
 
 /** @}*/
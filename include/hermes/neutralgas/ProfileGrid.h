@@ -0,0 +1,56 @@
+#ifndef HERMES_NEUTRALGAS_PROFILEGRID_H
+#define HERMES_NEUTRALGAS_PROFILEGRID_H
+
+#include <memory>
+#include <vector>
+
+#include "hermes/BakedGrid.h"
+#include "hermes/neutralgas/ProfileAbstract.h"
+
+namespace hermes { namespace neutralgas {
+/**
+ * \addtogroup NeutralGas
+ * @{
+ */
+
+/**
+ @class ProfileGrid
+ @brief Any ProfileAbstract sampled on a BakedGrid, one grid per GasType,
+ and trilinearly interpolated
+
+ Positions outside of the grids are passed to the baked model, or have zero
+ density if the grids were loaded from files. The grids hold the densities
+ in 1/m^3 and can be saved with dumpGrid(getGrid(gas), filename).
+ */
+class ProfileGrid : public ProfileAbstract {
+  private:
+	std::shared_ptr<ProfileAbstract> model;
+	BakedGrid gridHI, gridH2;
+	QPDensity maxErrorHI, maxErrorH2;
+
+	const BakedGrid &getBakedGrid(GasType gas) const;
+
+  public:
+	/** Sample HI and H2 of the model on copies of grid, in parallel and
+	 * through its getPDensities(), and compare the results with the model at
+	 * validationPoints random positions inside the grid */
+	ProfileGrid(const std::shared_ptr<ProfileAbstract> &model,
+	            const BakedGrid &grid, std::size_t validationPoints = 10000);
+	/** Use already filled grids, e.g. after loadGrid() */
+	ProfileGrid(const BakedGrid &gridHI, const BakedGrid &gridH2);
+
+	QPDensity getPDensity(GasType gas,
+	                      const Vector3QLength &pos) const override;
+
+	/** Largest interpolation error found at the validation points */
+	QPDensity getMaxError(GasType gas) const;
+
+	std::shared_ptr<ScalarGrid> getGrid(GasType gas) const {
+		return getBakedGrid(gas).getGrid();
+	}
+};
+
+/** @}*/
+}}  // namespace hermes::neutralgas
+
+#endif  // HERMES_NEUTRALGAS_PROFILEGRID_H
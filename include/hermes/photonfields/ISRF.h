@@ -2,6 +2,9 @@
 #define HERMES_ISRF_H
 
 #include <array>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "hermes/photonfields/PhotonField.h"
 
@@ -11,6 +14,16 @@ namespace hermes { namespace photonfields {
  * @{
  */
 
+/**
+ @class ISRF
+ @brief Interstellar radiation field of Vernetto & Lipari 2016
+
+ The spectra are tabulated on a (r, z, wavelength) grid. They are read from
+ the binary file RadiationField/Vernetto16.bin of the data path when it
+ exists, which is memory-mapped and shared between processes, otherwise the
+ 720 text files of RadiationField/Vernetto16/ are parsed in parallel. The
+ binary file is written by saveBinary().
+ */
 class ISRF : public PhotonField {
   private:
 	const static int freqR1 = 200;
@@ -25,17 +38,64 @@ class ISRF : public PhotonField {
 	                               0.8,  1.0,  1.2, 1.5, 2.0,  2.5,  3.0,
 	                               4.0,  5.0,  6.0, 8.0, 10.0, 12.0, 15.0,
 	                               20.0, 25.0, 30.0};  // in kpc (24)
-	std::vector<double> isrf;
+	std::shared_ptr<const double> isrf; /**< wavelength running fastest */
+	std::size_t isrfSize;
+	/** wavelength index and weight of every energy of the energy axis, the
+	 * index is logwavelenghts.size() outside of the tabulated range */
+	std::vector<std::size_t> energyFreqIndex;
+	std::vector<double> energyFreqWeight;
+	/** low-rank form from compress(): component spectra at the energy axis
+	 * and weights at the (r, z) nodes, k running fastest */
+	std::vector<std::vector<QEnergyDensity>> componentSpectra;
+	std::vector<double> componentWeights;
+	double compressionError;
 
+	void init();
 	void buildEnergyRange();
 
 	double getISRF(std::size_t ir, std::size_t iz, std::size_t ifreq) const;
+	/** Lower wavelength index and interpolation weight of a photon energy,
+	 * false if it is outside of the tabulated range */
+	bool getFrequencyIndex(const QEnergy &E_photon, std::size_t &ifreq,
+	                       double &f_d) const;
+	/** Lower r and z indices and interpolation weights of a position,
+	 * false if it is outside of the table */
+	bool getSpatialIndex(const QLength &r, const QLength &z, std::size_t &ir,
+	                     std::size_t &iz, double &r_d, double &z_d) const;
+	QEnergyDensity interpolate(const QLength &r, const QLength &z,
+	                           std::size_t ifreq, double f_d) const;
 
 	void loadFrequencyAxis();
 	void loadISRF();
+	void mapISRF(const std::string &filename);
 
   public:
 	ISRF();
+	/** Map a binary file written by saveBinary() */
+	explicit ISRF(const std::string &filename);
+
+	/** Write the table to a binary grid file (see dumpMappedGrid()) with
+	 * Nx, Ny, Nz the number of r, z and wavelength nodes */
+	void saveBinary(const std::string &filename) const;
+
+	/** Decompose the table at the energy axis into nComponents separable
+	 * components w_k(r, z) b_k(E) by a truncated SVD, b_k being the leading
+	 * eigenvectors of the Gram matrix of the spectra of all (r, z) nodes.
+	 * Integrators which support it use the components instead of the full
+	 * spectra, getEnergyDensity() is not affected; 0 removes them.
+	 * @return relative reconstruction error of the table (Frobenius norm)
+	 */
+	double compress(std::size_t nComponents);
+	double getCompressionError() const { return compressionError; }
+
+	std::size_t getNumberOfComponents() const override {
+		return componentSpectra.size();
+	}
+	const std::vector<QEnergyDensity> &getComponentSpectrum(
+	    std::size_t k) const override;
+	void getComponentWeights(const Vector3QLength &pos,
+	                         std::vector<double> &weights) const override;
+
 	std::size_t getSize() const;
 	QEnergyDensity getEnergyDensity(const QLength &r, const QLength &z,
 	                                const QEnergy &E_photon) const;
@@ -43,6 +103,13 @@ class ISRF : public PhotonField {
 	                                const QEnergy &E_photon) const override;
 	QEnergyDensity getEnergyDensity(const Vector3QLength &pos_,
 	                                std::size_t iE_) const override;
+	void getEnergyDensities(
+	    const std::vector<Vector3QLength> &positions, std::size_t iE_,
+	    std::vector<QEnergyDensity> &densities) const override;
+	/** The spatial interpolation is done once, the eight neighbours of
+	 * every energy are then taken from four neighbouring spectra */
+	void getSpectrum(const Vector3QLength &pos,
+	                 std::vector<QEnergyDensity> &spectrum) const override;
 };
 
 /** @}*/
@@ -1,6 +1,9 @@
 #ifndef HERMES_PHOTONFIELD_H
 #define HERMES_PHOTONFIELD_H
 
+#include <stdexcept>
+#include <vector>
+
 #include "hermes/Grid.h"
 #include "hermes/Units.h"
 
@@ -18,6 +21,7 @@ class PhotonField {
 	bool scaleFactorFlag;
 	double energyScaleFactor;
 	QEnergy startEnergy, endEnergy;
+	std::size_t componentsVersion = 0;
 
   public:
 	typedef tEnergyRange::iterator iterator;
@@ -32,6 +36,47 @@ class PhotonField {
 	virtual QEnergyDensity getEnergyDensity(const Vector3QLength &pos,
 	                                        std::size_t iE) const = 0;
 
+	/** Energy density at the iE-th energy for many positions with a single
+	 * virtual call, densities is resized to the number of positions */
+	virtual void getEnergyDensities(
+	    const std::vector<Vector3QLength> &positions, std::size_t iE,
+	    std::vector<QEnergyDensity> &densities) const {
+		densities.resize(positions.size());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			densities[i] = getEnergyDensity(positions[i], iE);
+	}
+
+	/** Energy density at all energies of the energy axis at a given
+	 * position, spectrum[i] corresponds to the i-th energy; integrators
+	 * fetch it once per position instead of calling getEnergyDensity() for
+	 * every photon energy, tabulated fields override it to compute the
+	 * spatial interpolation only once */
+	virtual void getSpectrum(const Vector3QLength &pos,
+	                         std::vector<QEnergyDensity> &spectrum) const {
+		spectrum.resize(energyRange.size());
+		for (std::size_t i = 0; i < energyRange.size(); ++i)
+			spectrum[i] = getEnergyDensity(pos, i);
+	}
+
+	/** Number of components of a low-rank form of the field,
+	 * u(pos, E_i) ~ sum_k w_k(pos) b_k(E_i); 0 if the field has none.
+	 * Integrators contract their kernels with the component spectra b_k
+	 * once per energy, what remains per position is a sum over k */
+	virtual std::size_t getNumberOfComponents() const { return 0; }
+	/** Spectrum b_k of the k-th component at the energy axis */
+	virtual const std::vector<QEnergyDensity> &getComponentSpectrum(
+	    std::size_t k) const {
+		throw std::runtime_error("PhotonField: no low-rank components");
+	}
+	/** Weights w_k(pos) of all components at a given position */
+	virtual void getComponentWeights(const Vector3QLength &pos,
+	                                 std::vector<double> &weights) const {
+		weights.clear();
+	}
+	/** Incremented whenever the components are replaced, integrators key
+	 * the kernels they contract with the components on it */
+	std::size_t getComponentsVersion() const { return componentsVersion; }
+
 	void setStartEnergy(QEnergy E_) { startEnergy = E_; }
 
 	void setEndEnergy(QEnergy E_) { endEnergy = E_; }
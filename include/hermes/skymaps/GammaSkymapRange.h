@@ -35,6 +35,8 @@ class GammaSkymapRange {
 
 	std::size_t size() const;
 	GammaSkymap operator[](std::size_t ipix) const;
+	/** Energies of the skymaps in ascending order */
+	std::vector<QEnergy> getEnergies() const;
 
 	void compute();
 
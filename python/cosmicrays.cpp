@@ -1,6 +1,9 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <limits>
+#include <map>
+
 #include "hermes/cosmicrays/CosmicRayDensity.h"
 #include "hermes/cosmicrays/Dragon2D.h"
 #include "hermes/cosmicrays/Dragon3D.h"
@@ -20,8 +23,20 @@ void init(py::module &m) {
 	// charged gas density models
 	py::class_<CosmicRayDensity, std::shared_ptr<CosmicRayDensity>>(
 	    subm, "CosmicRayDensity")
-	    .def("getDensityPerEnergy", &CosmicRayDensity::getDensityPerEnergy)
-	    .def("getEnergyAxis", &CosmicRayDensity::getEnergyAxis);
+	    .def("getDensityPerEnergy",
+	         static_cast<QPDensityPerEnergy (CosmicRayDensity::*)(
+	             const QEnergy &, const Vector3QLength &) const>(
+	             &CosmicRayDensity::getDensityPerEnergy))
+	    .def("getDensityPerEnergyIndex",
+	         static_cast<QPDensityPerEnergy (CosmicRayDensity::*)(
+	             std::size_t, const Vector3QLength &) const>(
+	             &CosmicRayDensity::getDensityPerEnergy))
+	    .def("getEnergyAxis", &CosmicRayDensity::getEnergyAxis)
+	    .def("isProjectileWeighted", &CosmicRayDensity::isProjectileWeighted)
+	    .def("getProjectileWeights", &CosmicRayDensity::getProjectileWeights)
+	    .def("isSeparable", &CosmicRayDensity::isSeparable)
+	    .def("getSpectralShape", &CosmicRayDensity::getSpectralShape)
+	    .def("getSpatialProfile", &CosmicRayDensity::getSpatialProfile);
 	py::class_<DummyCRDensity, std::shared_ptr<DummyCRDensity>,
 	           CosmicRayDensity>(subm, "DummyCRDensity")
 	    .def(py::init<>())
@@ -45,6 +60,17 @@ void init(py::module &m) {
 	    .def(py::init<const PID &>())
 	    .def(py::init<const std::vector<PID> &>())
 	    .def(py::init<const std::string, const std::vector<PID> &>())
+	    .def(py::init<const std::string, const std::vector<PID> &,
+	                  const QEnergy &, const QEnergy &>(),
+	         py::arg("filename"), py::arg("PIDs"), py::arg("E_min"),
+	         py::arg("E_max") =
+	             QEnergy(std::numeric_limits<double>::infinity()))
+	    .def(py::init<const std::string, const std::map<PID, double> &,
+	                  const QEnergy &, const QEnergy &>(),
+	         py::arg("filename"), py::arg("weights"),
+	         py::arg("E_min") = QEnergy(0),
+	         py::arg("E_max") =
+	             QEnergy(std::numeric_limits<double>::infinity()))
 	    .def("getDensityPerEnergy",
 	         static_cast<QPDensityPerEnergy (Dragon2D::*)(
 	             const QEnergy &, const Vector3QLength &) const>(
@@ -11,8 +11,10 @@
 #include "hermes/integrators/PiZeroAbsorptionIntegrator.h"
 #include "hermes/integrators/PiZeroIntegrator.h"
 #include "hermes/integrators/RotationMeasureIntegrator.h"
+#include "hermes/integrators/RotationMeasureIntegratorT.h"
 #include "hermes/integrators/SynchroAbsorptionIntegrator.h"
 #include "hermes/integrators/SynchroIntegrator.h"
+#include "hermes/integrators/SynchroIntegratorT.h"
 
 // clang-format off
 #define PPCAT(A, B) A##B
@@ -53,6 +55,17 @@ void init_integrators(py::module &m) {
 	             const std::shared_ptr<chargedgas::ChargedGasDensity>>());
 	declare_default_integrator_methods<RotationMeasureIntegrator>(rmintegrator);
 
+	// RotationMeasureIntegrator specialised for JF12 and YMW16
+	py::class_<RotationMeasureIntegratorJF12YMW16, RotationMeasureIntegrator,
+	           std::shared_ptr<RotationMeasureIntegratorJF12YMW16>>
+	    rmintegratorjf12ymw16(m, "RotationMeasureIntegratorJF12YMW16",
+	                          py::buffer_protocol());
+	rmintegratorjf12ymw16.def(
+	    py::init<const std::shared_ptr<magneticfields::JF12>,
+	             const std::shared_ptr<chargedgas::YMW16>>());
+	declare_default_integrator_methods<RotationMeasureIntegratorJF12YMW16>(
+	    rmintegratorjf12ymw16);
+
 	// FreeFreeIntegrator
 	NEW_INTEGRATOR(ffintegrator, "FreeFreeIntegrator", FreeFreeIntegrator,
 	               QTemperature, QFrequency);
@@ -67,8 +80,25 @@ void init_integrators(py::module &m) {
 	synchrointegrator.def(
 	    py::init<const std::shared_ptr<magneticfields::MagneticField>,
 	             const std::shared_ptr<cosmicrays::CosmicRayDensity>>());
+	synchrointegrator.def("setUseSeparableTable",
+	                      &SynchroIntegrator::setUseSeparableTable);
+	synchrointegrator.def("isUsingSeparableTable",
+	                      &SynchroIntegrator::isUsingSeparableTable);
 	declare_default_integrator_methods<SynchroIntegrator>(synchrointegrator);
 
+#ifdef HERMES_HAVE_CFITSIO
+	// SynchroIntegrator specialised for JF12 and Dragon2D
+	py::class_<SynchroIntegratorJF12Dragon2D, SynchroIntegrator,
+	           std::shared_ptr<SynchroIntegratorJF12Dragon2D>>
+	    synchrointegratorjf12dragon2d(m, "SynchroIntegratorJF12Dragon2D",
+	                                  py::buffer_protocol());
+	synchrointegratorjf12dragon2d.def(
+	    py::init<const std::shared_ptr<magneticfields::JF12>,
+	             const std::shared_ptr<cosmicrays::Dragon2D>>());
+	declare_default_integrator_methods<SynchroIntegratorJF12Dragon2D>(
+	    synchrointegratorjf12dragon2d);
+#endif  // HERMES_HAVE_CFITSIO
+
 	// SynchroAbsorption
 	py::class_<SynchroAbsorptionIntegrator, FreeFreeIntegratorParentClass,
 	           std::shared_ptr<SynchroAbsorptionIntegrator>>
@@ -90,10 +120,16 @@ void init_integrators(py::module &m) {
 	        const std::shared_ptr<photonfields::PhotonField>,
 	        const std::shared_ptr<interactions::DifferentialCrossSection>>());
 	declare_default_integrator_methods<InverseComptonIntegrator>(icintegrator);
-	icintegrator.def("integrateOverEnergy",
-	                 &InverseComptonIntegrator::integrateOverEnergy);
-	icintegrator.def("integrateOverPhotonEnergy",
-	                 &InverseComptonIntegrator::integrateOverPhotonEnergy);
+	icintegrator.def(
+	    "integrateOverEnergy",
+	    static_cast<QGREmissivity (InverseComptonIntegrator::*)(
+	        const Vector3QLength &, const QEnergy &) const>(
+	        &InverseComptonIntegrator::integrateOverEnergy));
+	icintegrator.def(
+	    "integrateOverPhotonEnergy",
+	    static_cast<QICInnerIntegral (InverseComptonIntegrator::*)(
+	        const Vector3QLength &, const QEnergy &, const QEnergy &) const>(
+	        &InverseComptonIntegrator::integrateOverPhotonEnergy));
 	icintegrator.def("getLOSProfile", &InverseComptonIntegrator::getLOSProfile);
 
 	// PiZeroIntegrator
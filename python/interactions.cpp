@@ -26,7 +26,13 @@ void init(py::module &m) {
 	    subm, "DifferentialCrossSection")
 	    .def(py::init<bool>(), py::arg("cachingEnabled"))
 	    .def("enableCaching", &DifferentialCrossSection::enableCaching)
-	    .def("disableCaching", &DifferentialCrossSection::disableCaching);
+	    .def("disableCaching", &DifferentialCrossSection::disableCaching)
+	    .def("getProjectileWeights",
+	         &DifferentialCrossSection::getProjectileWeights,
+	         py::arg("projectiles"), py::arg("targets"))
+	    .def("checkProjectileWeights",
+	         &DifferentialCrossSection::checkProjectileWeights,
+	         py::arg("weights"), py::arg("targets"));
 
 	py::class_<DummyCrossSection, std::shared_ptr<DummyCrossSection>,
 	           DifferentialCrossSection>(subm, "DummyCrossSection")
@@ -86,6 +92,11 @@ void init(py::module &m) {
 	py::class_<BremsstrahlungGALPROP, std::shared_ptr<BremsstrahlungGALPROP>,
 	           BremsstrahlungAbstract>(subm, "BremsstrahlungGALPROP")
 	    .def(py::init<>())
+	    .def("enableCaching", &BremsstrahlungGALPROP::enableCaching)
+	    .def("disableCaching", &BremsstrahlungGALPROP::disableCaching)
+	    .def("enableTable", &BremsstrahlungGALPROP::enableTable)
+	    .def("disableTable", &BremsstrahlungGALPROP::disableTable)
+	    .def("isTableEnabled", &BremsstrahlungGALPROP::isTableEnabled)
 	    .def("getDiffCrossSectionForTarget",
 	         &BremsstrahlungGALPROP::getDiffCrossSectionForTarget);
 
@@ -98,6 +109,8 @@ void init(py::module &m) {
 	py::class_<BreitWheeler, std::shared_ptr<BreitWheeler>>(subm,
 	                                                        "BreitWheeler")
 	    .def(py::init<>())
+	    .def("setUseTable", &BreitWheeler::setUseTable)
+	    .def("isUsingTable", &BreitWheeler::isUsingTable)
 	    .def("getCrossSection", &BreitWheeler::getCrossSection)
 	    .def("integratedOverTheta", &BreitWheeler::integratedOverTheta);
 }
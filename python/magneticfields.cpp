@@ -5,6 +5,7 @@
 #include "hermes/magneticfields/MagneticField.h"
 #include "hermes/magneticfields/MagneticFieldGrid.h"
 #include "hermes/magneticfields/PT11Field.h"
+#include "hermes/magneticfields/PlaneWaveTurbulence.h"
 #include "hermes/magneticfields/Sun08Field.h"
 #include "hermes/magneticfields/WMAP07Field.h"
 
@@ -30,9 +31,19 @@ void init(py::module &m) {
 	    .def(py::init<>())
 	    .def("getField", &MagneticField::getField);
 
+	py::class_<PlaneWaveTurbulence, std::shared_ptr<PlaneWaveTurbulence>,
+	           MagneticField>(subm, "PlaneWaveTurbulence")
+	    .def(py::init<const QMField &, const QLength &, const QLength &, int,
+	                  int, double>(),
+	         py::arg("Brms"), py::arg("lMin"), py::arg("lMax"),
+	         py::arg("nModes") = 1000, py::arg("seed") = 0,
+	         py::arg("alpha") = -11. / 3.)
+	    .def("getField", &MagneticField::getField);
+
 	py::class_<JF12, std::shared_ptr<JF12>, MagneticField>(
 	    subm, "JF12")
 	    .def(py::init<>())
+	    .def("setTurbulentModes", &JF12::setTurbulentModes)
 	    .def("getField", &MagneticField::getField);
 }
 
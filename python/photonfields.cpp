@@ -27,7 +27,11 @@ void init(py::module &m) {
 	py::class_<CMB, std::shared_ptr<CMB>, PhotonField>(subm, "CMB")
 	    .def(py::init<>());
 	py::class_<ISRF, std::shared_ptr<ISRF>, PhotonField>(subm, "ISRF")
-	    .def(py::init<>());
+	    .def(py::init<>())
+	    .def(py::init<const std::string &>(), py::arg("filename"))
+	    .def("saveBinary", &ISRF::saveBinary, py::arg("filename"))
+	    .def("compress", &ISRF::compress, py::arg("nComponents"))
+	    .def("getCompressionError", &ISRF::getCompressionError);
 }
 
 }}  // namespace hermes::photonfields
@@ -0,0 +1,146 @@
+#include "hermes/BakedGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include "hermes/Common.h"
+#include "hermes/Random.h"
+
+namespace hermes {
+
+BakedGrid::BakedGrid(const Vector3QLength &origin, size_t Nx, size_t Ny,
+                     size_t Nz, const Vector3QLength &spacing) {
+	if (Nx < 2 || Ny < 2 || Nz < 2)
+		throw std::runtime_error(
+		    "BakedGrid: at least 2 grid points per axis are needed");
+
+	grid = std::make_shared<ScalarGrid>(origin.getValue(), Nx, Ny, Nz,
+	                                    spacing.getValue());
+	grid->setReflective(true);
+	lower = grid->getOrigin() + grid->getSpacing() / 2;
+	upper = grid->getOrigin() +
+	        Vector3d(Nx - 0.5, Ny - 0.5, Nz - 0.5) * grid->getSpacing();
+}
+
+BakedGrid::BakedGrid(const Vector3QLength &origin, size_t Nx, size_t Ny,
+                     const Vector3QLength &spacing,
+                     const std::vector<QLength> &zAxis_) {
+	if (Nx < 2 || Ny < 2 || zAxis_.size() < 2)
+		throw std::runtime_error(
+		    "BakedGrid: at least 2 grid points per axis are needed");
+	for (std::size_t i = 1; i < zAxis_.size(); ++i)
+		if (!(zAxis_[i] > zAxis_[i - 1]))
+			throw std::runtime_error("BakedGrid: z axis is not increasing");
+
+	for (auto z : zAxis_) zAxis.push_back(static_cast<double>(z));
+
+	// along z the underlying grid runs over the plane index, plane iz lies
+	// at the grid coordinate iz
+	Vector3d o = origin.getValue();
+	Vector3d s = spacing.getValue();
+	grid = std::make_shared<ScalarGrid>(Vector3d(o.x, o.y, -0.5), Nx, Ny,
+	                                    zAxis.size(), Vector3d(s.x, s.y, 1));
+	grid->setReflective(true);
+	lower = Vector3d(o.x + s.x / 2, o.y + s.y / 2, zAxis.front());
+	upper = Vector3d(o.x + (Nx - 0.5) * s.x, o.y + (Ny - 0.5) * s.y,
+	                 zAxis.back());
+}
+
+BakedGrid::BakedGrid(const BakedGrid &other)
+    : grid(std::make_shared<ScalarGrid>(*other.grid)),
+      zAxis(other.zAxis),
+      lower(other.lower),
+      upper(other.upper) {}
+
+BakedGrid &BakedGrid::operator=(const BakedGrid &other) {
+	if (this != &other) {
+		grid = std::make_shared<ScalarGrid>(*other.grid);
+		zAxis = other.zAxis;
+		lower = other.lower;
+		upper = other.upper;
+	}
+	return *this;
+}
+
+double BakedGrid::gridZ(double z) const {
+	std::ptrdiff_t i =
+	    std::upper_bound(zAxis.begin(), zAxis.end(), z) - zAxis.begin() - 1;
+	i = std::max<std::ptrdiff_t>(
+	    0, std::min<std::ptrdiff_t>(i, zAxis.size() - 2));
+	return i + (z - zAxis[i]) / (zAxis[i + 1] - zAxis[i]);
+}
+
+Vector3QLength BakedGrid::getPosition(size_t ix, size_t iy, size_t iz) const {
+	Vector3d pos = grid->getOrigin() +
+	               Vector3d(ix + 0.5, iy + 0.5, iz + 0.5) * grid->getSpacing();
+	if (!zAxis.empty()) pos.z = zAxis[iz];
+	return Vector3QLength(pos);
+}
+
+bool BakedGrid::isInside(const Vector3QLength &pos) const {
+	Vector3d r = pos.getValue();
+	return r.x >= lower.x && r.x <= upper.x && r.y >= lower.y &&
+	       r.y <= upper.y && r.z >= lower.z && r.z <= upper.z;
+}
+
+double BakedGrid::interpolate(const Vector3QLength &pos) const {
+	Vector3d r = pos.getValue();
+	if (!zAxis.empty()) r.z = gridZ(r.z);
+	return grid->interpolate(r);
+}
+
+void BakedGrid::bake(const BatchFunction &f) {
+	size_t Ny = grid->getNy();
+	size_t Nz = grid->getNz();
+
+	// every thread fills whole z columns, so no two threads write the same
+	// grid point
+	auto fillColumns = [this, &f, Ny, Nz](unsigned int start,
+	                                      unsigned int stop) {
+		std::vector<Vector3QLength> positions(Nz);
+		std::vector<double> values;
+		for (unsigned int i = start; i < stop; ++i) {
+			size_t ix = i / Ny;
+			size_t iy = i % Ny;
+			for (size_t iz = 0; iz < Nz; ++iz)
+				positions[iz] = getPosition(ix, iy, iz);
+			f(positions, values);
+			for (size_t iz = 0; iz < Nz; ++iz)
+				grid->get(ix, iy, iz) = values[iz];
+		}
+	};
+
+	auto job_chunks = getThreadChunks(grid->getNx() * Ny);
+	std::vector<std::thread> threads;
+	for (auto &chunk : job_chunks)
+		threads.push_back(std::thread(fillColumns, chunk.first, chunk.second));
+	for (auto &t : threads) t.join();
+}
+
+double BakedGrid::maxError(const BatchFunction &f, std::size_t n,
+                           double &maxValue, int seed) const {
+	Random random;
+	random.seed(seed);
+	std::vector<Vector3QLength> positions(n);
+	for (auto &pos : positions)
+		pos = Vector3QLength(
+		    Vector3d(random.randUniform(lower.x, upper.x),
+		             random.randUniform(lower.y, upper.y),
+		             random.randUniform(lower.z, upper.z)));
+
+	std::vector<double> values;
+	f(positions, values);
+
+	double error = 0;
+	maxValue = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		error = std::max(error, std::fabs(interpolate(positions[i]) -
+		                                  values[i]));
+		maxValue = std::max(maxValue, std::fabs(values[i]));
+	}
+	return error;
+}
+
+}  // namespace hermes
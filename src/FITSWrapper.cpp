@@ -2,6 +2,8 @@
 
 #include "hermes/FITSWrapper.h"
 
+#include <algorithm>
+#include <future>
 #include <iostream>
 #include <stdexcept>
 
@@ -214,6 +216,81 @@ std::vector<float> FITSFile::readImageAsFloat(unsigned int firstElement,
 	return resultArray;
 }
 
+std::vector<long> FITSFile::getImageSize() {
+	int naxis = 0;
+	if (fits_get_img_dim(fptr, &naxis, &status))
+		fits_report_error(stderr, status);
+	std::vector<long> naxes(naxis, 0);
+	if (naxis > 0 && fits_get_img_size(fptr, naxis, naxes.data(), &status))
+		fits_report_error(stderr, status);
+	if (status != 0)
+		throw std::runtime_error("hermes: error: Cannot read image size.");
+
+	return naxes;
+}
+
+std::vector<float> FITSFile::readImageSubsetAsFloat(
+    const std::vector<long> &first, const std::vector<long> &last) {
+	std::size_t nElements = 1;
+	for (std::size_t i = 0; i < first.size(); ++i)
+		nElements *= last[i] - first[i] + 1;
+	std::vector<float> resultArray(nElements, 0);
+	std::vector<long> fpixel(first), lpixel(last), inc(first.size(), 1);
+	float nullval = 0;
+	int anynul = -1;
+
+	if (nElements == 0)
+		throw std::runtime_error("hermes: error: Cannot read image of size 0.");
+	if (fits_read_subset(fptr, TFLOAT, fpixel.data(), lpixel.data(),
+	                     inc.data(), &nullval, resultArray.data(), &anynul,
+	                     &status))
+		fits_report_error(stderr, status);
+	if (status != 0)
+		throw std::runtime_error("hermes: error: Cannot read image subset.");
+
+	return resultArray;
+}
+
+void FITSFile::readImageInSlabs(
+    std::size_t planeSize, std::size_t nPlanes, std::size_t planesPerSlab,
+    const std::function<void(std::size_t, std::size_t,
+                             const std::vector<float> &)> &process) {
+	// use rectangular subsets if the last image axis is the plane axis,
+	// otherwise contiguous element ranges which hold the same values
+	std::vector<long> naxes = getImageSize();
+	std::size_t lastAxisStride = 1;
+	for (std::size_t i = 0; i + 1 < naxes.size(); ++i)
+		lastAxisStride *= naxes[i];
+	bool useSubsets = naxes.size() > 1 && lastAxisStride == planeSize &&
+	                  static_cast<std::size_t>(naxes.back()) == nPlanes;
+
+	auto readSlab = [this, &naxes, planeSize, useSubsets](std::size_t p0,
+	                                                      std::size_t n) {
+		if (!useSubsets)
+			return readImageAsFloat(p0 * planeSize + 1, n * planeSize);
+		std::vector<long> first(naxes.size(), 1), last(naxes);
+		first.back() = p0 + 1;
+		last.back() = p0 + n;
+		return readImageSubsetAsFloat(first, last);
+	};
+
+	planesPerSlab = std::max<std::size_t>(1, planesPerSlab);
+	std::vector<float> slab = readSlab(0, std::min(planesPerSlab, nPlanes));
+	for (std::size_t p0 = 0; p0 < nPlanes; p0 += planesPerSlab) {
+		std::size_t n = std::min(planesPerSlab, nPlanes - p0);
+		std::size_t p1 = p0 + n;
+
+		// read ahead while the current slab is processed; cfitsio is only
+		// ever called from one thread at a time
+		std::future<std::vector<float>> next;
+		if (p1 < nPlanes)
+			next = std::async(std::launch::async, readSlab, p1,
+			                  std::min(planesPerSlab, nPlanes - p1));
+		process(p0, n, slab);
+		if (p1 < nPlanes) slab = next.get();
+	}
+}
+
 void FITSFile::createTable(FITS::HDUType tableType, long int nRows,
                            int nColumns, char *columnName[], char *columnType[],
                            char *columnUnit[], const char *tableName) {
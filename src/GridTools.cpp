@@ -1,12 +1,20 @@
 #include "hermes/GridTools.h"
 
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <sstream>
+#include <thread>
+#include <vector>
 
+#include "hermes/Common.h"
 #include "hermes/Random.h"
 #include "hermes/magneticfields/MagneticField.h"
 
+#ifdef HERMES_HAVE_FFTW3F
+#include "fftw3.h"
+#endif
+
 namespace hermes {
 
 void scaleGrid(const std::shared_ptr<ScalarGrid>& grid, double a) {
@@ -82,7 +90,77 @@ double rmsFieldStrength(const std::shared_ptr<ScalarGrid>& grid) {
 }
 
 #ifdef HERMES_HAVE_FFTW3F
-#include "fftw3.h"
+/* Complex amplitude of the turbulent mode with wave vector ek (in units of
+ * the inverse grid spacing), from the four random integers u */
+static void turbulentMode(const Vector3f& ek, double alpha, bool helicity,
+                          double H, const uint32_t u[4], Vector3f& re,
+                          Vector3f& im) {
+	double k = ek.getR();
+	Vector3f e1, e2;       // orthogonal base together with ek
+	Vector3f n0(1, 1, 1);  // arbitrary vector to construct orthogonal base
+
+	// construct an orthogonal base ek, e1, e2
+	// (for helical fields together with the real
+	// transform the following convention must be
+	// used: e1(-k) = e1(k), e2(-k) = - e2(k)
+	if (helicity == true) {
+		if (ek.getAngleTo(n0) < 1e-3_rad) {  // ek parallel to (1,1,1)
+			e1.setXYZ(-1, 1, 0);
+			e2.setXYZ(1, 1, -2);
+		} else {  // ek not parallel to (1,1,1)
+			e1 = n0.cross(ek);
+			e2 = ek.cross(e1);
+		}
+		e1 /= e1.getR();
+		e2 /= e2.getR();
+
+		double Bkprefactor =
+		    static_cast<double>(mu0) / (4 * M_PI * std::pow(k, 3));
+		double Bktot =
+		    fabs(CounterRandom::toNormal(u[0], u[1]) * std::pow(k, alpha / 2));
+		double Bkplus = Bkprefactor * sqrt((1 + H) / 2) * Bktot;
+		double Bkminus = Bkprefactor * sqrt((1 - H) / 2) * Bktot;
+		double thetaplus = 2 * M_PI * CounterRandom::toUniform(u[2]);
+		double thetaminus = 2 * M_PI * CounterRandom::toUniform(u[3]);
+		double ctp = cos(thetaplus);
+		double stp = sin(thetaplus);
+		double ctm = cos(thetaminus);
+		double stm = sin(thetaminus);
+
+		re = (e1 * (Bkplus * ctp + Bkminus * ctm) +
+		      e2 * (-Bkplus * stp + Bkminus * stm)) /
+		     sqrt(2);
+		im = (e1 * (Bkplus * stp + Bkminus * stm) +
+		      e2 * (Bkplus * ctp - Bkminus * ctm)) /
+		     sqrt(2);
+	} else {  // no helicity
+		if (ek.isParallelTo(n0, 1e-3_rad)) {
+			// ek parallel to (1,1,1)
+			e1.setXYZ(-1., 1., 0);
+			e2.setXYZ(1., 1., -2.);
+		} else {
+			// ek not parallel to (1,1,1)
+			e1 = n0.cross(ek);
+			e2 = ek.cross(e1);
+		}
+		e1 /= e1.getR();
+		e2 /= e2.getR();
+
+		// random orientation perpendicular to k
+		double theta = 2 * M_PI * CounterRandom::toUniform(u[0]);
+		Vector3f b = e1 * cos(theta) + e2 * sin(theta);
+
+		// normal distributed amplitude with
+		// mean = 0 and sigma = k^alpha/2
+		b *= CounterRandom::toNormal(u[1], u[2]) * std::pow(k, alpha / 2);
+
+		// uniform random phase
+		double phase = 2 * M_PI * CounterRandom::toUniform(u[3]);
+		re = b * cos(phase);
+		im = b * sin(phase);
+	}
+}
+
 void initTurbulence(std::shared_ptr<VectorGrid> grid, double Brms, double lMin,
                     double lMax, double alpha, int seed, bool helicity,
                     double H) {
@@ -106,174 +184,105 @@ void initTurbulence(std::shared_ptr<VectorGrid> grid, double Brms, double lMin,
 	size_t n2 = (size_t)std::floor(n / 2) +
 	            1;  // size array in z-direction in configuration space
 
-	// arrays to hold the complex vector components of the B(k)-field
-	fftwf_complex *Bkx, *Bky, *Bkz;
-	Bkx = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n * n * n2);
-	Bky = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n * n * n2);
-	Bkz = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n * n * n2);
+	// array to hold one complex component of the B(k)-field at a time,
+	// transformed in-place to the real component B(x)
+	fftwf_complex* Bk =
+	    (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n * n * n2);
+	float* B = (float*)Bk;
 
-	Random random;
-	if (seed != 0) random.seed(seed);  // use given seed
+	// the random numbers of a mode only depend on the seed and the k-space
+	// index, so the field does not depend on the number of threads and each
+	// component pass draws the same modes again
+	CounterRandom random((seed != 0) ? seed : Random().randInt());
 
 	// calculate the n possible discrete wave numbers
-	double K[n];
+	std::vector<double> K(n);
 	for (int i = 0; i < n; i++) K[i] = (double)i / n - i / (n / 2);
 
-	// construct the field in configuration space
-	int i;
-	double k;
-
-	// only used if there is a helicity
-	double Bktot, Bkplus, Bkminus, thetaplus, thetaminus;
-
-	// parameters goes for non helical calculations
-	double theta, phase, cosPhase, sinPhase;
-
 	double kMin = spacing.x / lMax;
 	double kMax = spacing.x / lMin;
-	Vector3f b;            // real b-field vector
-	Vector3f ek, e1, e2;   // orthogonal base
-	Vector3f n0(1, 1, 1);  // arbitrary vector to construct orthogonal base
 
-	for (size_t ix = 0; ix < n; ix++) {
-		for (size_t iy = 0; iy < n; iy++) {
-			for (size_t iz = 0; iz < n2; iz++) {
-				i = ix * n * n2 + iy * n2 + iz;
-				ek.setXYZ(K[ix], K[iy], K[iz]);
-				k = ek.getR();
-
-				// wave outside of turbulent range -> B(k) = 0
-				if ((k < kMin) || (k > kMax)) {
-					Bkx[i][0] = 0;
-					Bkx[i][1] = 0;
-					Bky[i][0] = 0;
-					Bky[i][1] = 0;
-					Bkz[i][0] = 0;
-					Bkz[i][1] = 0;
-					continue;
-				}
-
-				// construct an orthogonal base ek, e1, e2
-				// (for helical fields together with the real
-				// transform the following convention must be
-				// used: e1(-k) = e1(k), e2(-k) = - e2(k)
-				if (helicity == true) {
-					if (ek.getAngleTo(n0) < 1e-3_rad) {  // ek parallel to
-						                                 // (1,1,1)
-						e1.setXYZ(-1, 1, 0);
-						e2.setXYZ(1, 1, -2);
-					} else {  // ek not parallel to (1,1,1)
-						e1 = n0.cross(ek);
-						e2 = ek.cross(e1);
-					}
-					e1 /= e1.getR();
-					e2 /= e2.getR();
-
-					double Bkprefactor =
-					    static_cast<double>(mu0) / (4 * M_PI * std::pow(k, 3));
-					Bktot = fabs(random.randNorm() * std::pow(k, alpha / 2));
-					Bkplus = Bkprefactor * sqrt((1 + H) / 2) * Bktot;
-					Bkminus = Bkprefactor * sqrt((1 - H) / 2) * Bktot;
-					thetaplus = 2 * M_PI * random.rand();
-					thetaminus = 2 * M_PI * random.rand();
-					double ctp = cos(thetaplus);
-					double stp = sin(thetaplus);
-					double ctm = cos(thetaminus);
-					double stm = sin(thetaminus);
-
-					Bkx[i][0] = ((Bkplus * ctp + Bkminus * ctm) * e1.x +
-					             (-Bkplus * stp + Bkminus * stm) * e2.x) /
-					            sqrt(2);
-					Bkx[i][1] = ((Bkplus * stp + Bkminus * stm) * e1.x +
-					             (Bkplus * ctp - Bkminus * ctm) * e2.x) /
-					            sqrt(2);
-					Bky[i][0] = ((Bkplus * ctp + Bkminus * ctm) * e1.y +
-					             (-Bkplus * stp + Bkminus * stm) * e2.y) /
-					            sqrt(2);
-					Bky[i][1] = ((Bkplus * stp + Bkminus * stm) * e1.y +
-					             (Bkplus * ctp - Bkminus * ctm) * e2.y) /
-					            sqrt(2);
-					Bkz[i][0] = ((Bkplus * ctp + Bkminus * ctm) * e1.z +
-					             (-Bkplus * stp + Bkminus * stm) * e2.z) /
-					            sqrt(2);
-					Bkz[i][1] = ((Bkplus * stp + Bkminus * stm) * e1.z +
-					             (Bkplus * ctp - Bkminus * ctm) * e2.z) /
-					            sqrt(2);
-
-					Vector3f BkRe(Bkx[i][0], Bky[i][0], Bkz[i][0]);
-					Vector3f BkIm(Bkx[i][1], Bky[i][1], Bkz[i][1]);
-
-				} else {  // no helicity
-					if (ek.isParallelTo(n0, 1e-3_rad)) {
-						// ek parallel to (1,1,1)
-						e1.setXYZ(-1., 1., 0);
-						e2.setXYZ(1., 1., -2.);
-					} else {
-						// ek not parallel to (1,1,1)
-						e1 = n0.cross(ek);
-						e2 = ek.cross(e1);
+	auto fillPlanes = [&](int component, unsigned int start,
+	                      unsigned int stop) {
+		Vector3f ek, re, im;
+		uint32_t u[4];
+		for (size_t ix = start; ix < stop; ix++) {
+			for (size_t iy = 0; iy < n; iy++) {
+				for (size_t iz = 0; iz < n2; iz++) {
+					size_t i = ix * n * n2 + iy * n2 + iz;
+					ek.setXYZ(K[ix], K[iy], K[iz]);
+					double k = ek.getR();
+
+					// wave outside of turbulent range -> B(k) = 0
+					if ((k < kMin) || (k > kMax)) {
+						Bk[i][0] = 0;
+						Bk[i][1] = 0;
+						continue;
 					}
-					e1 /= e1.getR();
-					e2 /= e2.getR();
-
-					// random orientation perpendicular to k
-					theta = 2 * M_PI * random.rand();
-					b = e1 * cos(theta) + e2 * sin(theta);
-
-					// normal distributed amplitude with
-					// mean = 0 and sigma = k^alpha/2
-					b *= random.randNorm() * std::pow(k, alpha / 2);
-
-					// uniform random phase
-					phase = 2 * M_PI * random.rand();
-					cosPhase = cos(phase);  // real part
-					sinPhase = sin(phase);  // imaginary part
-
-					Bkx[i][0] = b.x * cosPhase;
-					Bkx[i][1] = b.x * sinPhase;
-					Bky[i][0] = b.y * cosPhase;
-					Bky[i][1] = b.y * sinPhase;
-					Bkz[i][0] = b.z * cosPhase;
-					Bkz[i][1] = b.z * sinPhase;
-
-				}  // non helical case
-			}      // for iz
-		}          // for iy
-	}              // for ix
-
-	// in-place, complex to real, inverse Fourier transformation on each
-	// component note that the last elements of B(x) are unused now
-	float* Bx = (float*)Bkx;
-	fftwf_plan plan_x = fftwf_plan_dft_c2r_3d(n, n, n, Bkx, Bx, FFTW_ESTIMATE);
-	fftwf_execute(plan_x);
-	fftwf_destroy_plan(plan_x);
-
-	float* By = (float*)Bky;
-	fftwf_plan plan_y = fftwf_plan_dft_c2r_3d(n, n, n, Bky, By, FFTW_ESTIMATE);
-	fftwf_execute(plan_y);
-	fftwf_destroy_plan(plan_y);
-
-	float* Bz = (float*)Bkz;
-	fftwf_plan plan_z = fftwf_plan_dft_c2r_3d(n, n, n, Bkz, Bz, FFTW_ESTIMATE);
-	fftwf_execute(plan_z);
-	fftwf_destroy_plan(plan_z);
-
-	// save to grid
-	for (size_t ix = 0; ix < n; ix++) {
-		for (size_t iy = 0; iy < n; iy++) {
-			for (size_t iz = 0; iz < n; iz++) {
-				i = ix * n * 2 * n2 + iy * 2 * n2 + iz;
-				Vector3f& b = grid->get(ix, iy, iz);
-				b.x = Bx[i];
-				b.y = By[i];
-				b.z = Bz[i];
+
+					random.block(i, 0, u);
+					turbulentMode(ek, alpha, helicity, H, u, re, im);
+					Bk[i][0] = (component == 0)   ? re.x
+					           : (component == 1) ? re.y
+					                              : re.z;
+					Bk[i][1] = (component == 0)   ? im.x
+					           : (component == 1) ? im.y
+					                              : im.z;
+				}
+			}
+		}
+	};
+
+	// the last elements of each B(x) row are unused after the transform
+	auto savePlanes = [&](int component, unsigned int start,
+	                      unsigned int stop) {
+		for (size_t ix = start; ix < stop; ix++) {
+			for (size_t iy = 0; iy < n; iy++) {
+				for (size_t iz = 0; iz < n; iz++) {
+					size_t i = ix * n * 2 * n2 + iy * 2 * n2 + iz;
+					Vector3f& b = grid->get(ix, iy, iz);
+					float& v = (component == 0)   ? b.x
+					           : (component == 1) ? b.y
+					                              : b.z;
+					v = B[i];
+				}
 			}
 		}
+	};
+
+	auto runParallel = [n](const std::function<void(unsigned int,
+	                                                 unsigned int)>& f) {
+		auto job_chunks = getThreadChunks(n);
+		std::vector<std::thread> threads;
+		for (auto& chunk : job_chunks)
+			threads.push_back(std::thread(f, chunk.first, chunk.second));
+		for (auto& t : threads) t.join();
+	};
+
+#ifdef HERMES_HAVE_FFTW3F_THREADS
+	static int fftwThreads = fftwf_init_threads();
+	if (fftwThreads != 0) fftwf_plan_with_nthreads(getThreadsNumber());
+#endif
+	// in-place, complex to real, inverse Fourier transformation; with
+	// FFTW_ESTIMATE the planner leaves the array untouched
+	fftwf_plan plan = fftwf_plan_dft_c2r_3d(n, n, n, Bk, B, FFTW_ESTIMATE);
+#ifdef HERMES_HAVE_FFTW3F_THREADS
+	// the plan keeps its threads, later FFTW plans get the default again
+	if (fftwThreads != 0) fftwf_plan_with_nthreads(1);
+#endif
+
+	for (int component = 0; component < 3; ++component) {
+		runParallel([&](unsigned int start, unsigned int stop) {
+			fillPlanes(component, start, stop);
+		});
+		fftwf_execute(plan);
+		runParallel([&](unsigned int start, unsigned int stop) {
+			savePlanes(component, start, stop);
+		});
 	}
 
-	fftwf_free(Bkx);
-	fftwf_free(Bky);
-	fftwf_free(Bkz);
+	fftwf_destroy_plan(plan);
+	fftwf_free(Bk);
 
 	scaleGrid(grid, Brms / rmsFieldStrength(grid));  // normalize to Brms
 }
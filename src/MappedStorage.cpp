@@ -0,0 +1,97 @@
+#include "hermes/MappedStorage.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace hermes {
+
+constexpr std::uint32_t GridFileHeader::currentVersion;
+constexpr std::uint64_t GridFileHeader::defaultDataOffset;
+
+MappedFile::MappedFile() : header(), address(nullptr), length(0) {}
+
+MappedFile::MappedFile(const std::string &filename_, bool writable)
+    : filename(filename_), header(), address(nullptr), length(0) {
+	int fd = open(filename.c_str(), writable ? O_RDWR : O_RDONLY);
+	if (fd < 0) {
+		std::stringstream ss;
+		ss << "MappedFile: " << filename << " not found";
+		throw std::runtime_error(ss.str());
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 ||
+	    static_cast<std::size_t>(st.st_size) < sizeof(GridFileHeader)) {
+		close(fd);
+		throw std::runtime_error("MappedFile: " + filename +
+		                         " is not a grid file");
+	}
+	length = st.st_size;
+
+	// shared mappings use the pages of the page cache directly
+	int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+	address = mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+	close(fd);
+	if (address == MAP_FAILED) {
+		address = nullptr;
+		throw std::runtime_error("MappedFile: cannot map " + filename);
+	}
+
+	std::memcpy(&header, address, sizeof(GridFileHeader));
+	std::size_t nBytes = header.Nx * header.Ny * header.Nz * header.elementSize;
+	if (std::strncmp(header.magic, "HRMSGRID", 8) != 0 ||
+	    header.version < 1 || header.version > GridFileHeader::currentVersion ||
+	    header.dataOffset + nBytes != length) {
+		unmap();
+		throw std::runtime_error("MappedFile: " + filename +
+		                         " is not a valid grid file");
+	}
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : filename(std::move(other.filename)),
+      header(other.header),
+      address(other.address),
+      length(other.length) {
+	other.address = nullptr;
+	other.length = 0;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+	if (this != &other) {
+		unmap();
+		filename = std::move(other.filename);
+		header = other.header;
+		address = other.address;
+		length = other.length;
+		other.address = nullptr;
+		other.length = 0;
+	}
+	return *this;
+}
+
+void MappedFile::unmap() {
+	if (address != nullptr) munmap(address, length);
+	address = nullptr;
+	length = 0;
+}
+
+void *MappedFile::getData() const {
+	return static_cast<char *>(address) + header.dataOffset;
+}
+
+void MappedFile::writeHeader(std::ostream &out, const GridFileHeader &header) {
+	std::vector<char> head(header.dataOffset, 0);
+	std::memcpy(head.data(), &header, sizeof(GridFileHeader));
+	out.write(head.data(), head.size());
+}
+
+}  // namespace hermes
@@ -437,4 +437,43 @@ Random &Random::instance() { return _random; }
 void Random::seedThreads(const uint32 oneSeed) { _random.seed(oneSeed); }
 #endif
 
+// Philox4x32 multipliers and Weyl sequence constants of the key schedule
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+CounterRandom::CounterRandom(uint64_t seed) {
+	key[0] = static_cast<uint32_t>(seed);
+	key[1] = static_cast<uint32_t>(seed >> 32);
+}
+
+void CounterRandom::block(uint64_t counter, uint64_t stream,
+                          uint32_t out[4]) const {
+	uint32_t c[4] = {static_cast<uint32_t>(counter),
+	                 static_cast<uint32_t>(counter >> 32),
+	                 static_cast<uint32_t>(stream),
+	                 static_cast<uint32_t>(stream >> 32)};
+	uint32_t k0 = key[0], k1 = key[1];
+	for (int round = 0; round < 10; ++round) {
+		uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c[0];
+		uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c[2];
+		uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+		uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+		c[0] = n0;
+		c[1] = static_cast<uint32_t>(p1);
+		c[2] = n2;
+		c[3] = static_cast<uint32_t>(p0);
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+	for (int i = 0; i < 4; ++i) out[i] = c[i];
+}
+
+double CounterRandom::rand(uint64_t counter, uint64_t stream) const {
+	uint32_t out[4];
+	block(counter, stream, out);
+	return toUniform(out[0]);
+}
+
 }  // namespace hermes
@@ -0,0 +1,49 @@
+#include "hermes/chargedgas/ChargedGasDensityGrid.h"
+
+#include "kiss/logger.h"
+
+namespace hermes { namespace chargedgas {
+
+ChargedGasDensityGrid::ChargedGasDensityGrid(
+    const std::shared_ptr<ChargedGasDensity> &model_, const BakedGrid &grid_,
+    std::size_t validationPoints)
+    : ChargedGasDensity(model_->getTemperature()),
+      model(model_),
+      grid(grid_),
+      maxError(0),
+      maxDensity(0) {
+	auto densities = [this](const std::vector<Vector3QLength> &positions,
+	                        std::vector<double> &values) {
+		thread_local std::vector<QPDensity> n;
+		model->getDensities(positions, n);
+		values.resize(n.size());
+		for (std::size_t i = 0; i < n.size(); ++i)
+			values[i] = static_cast<double>(n[i]);
+	};
+	grid.bake(densities);
+
+	if (validationPoints > 0) {
+		double maxValue;
+		maxError =
+		    QPDensity(grid.maxError(densities, validationPoints, maxValue));
+		maxDensity = QPDensity(maxValue);
+
+		double error_cm3 = static_cast<double>(maxError * 1_cm3);
+		double density_cm3 = static_cast<double>(maxDensity * 1_cm3);
+		KISS_LOG_INFO << "ChargedGasDensityGrid: max. interpolation error "
+		              << error_cm3 << " cm^-3, max. density " << density_cm3
+		              << " cm^-3" << std::endl;
+	}
+}
+
+ChargedGasDensityGrid::ChargedGasDensityGrid(const BakedGrid &grid_,
+                                             const QTemperature &T)
+    : ChargedGasDensity(T), grid(grid_), maxError(0), maxDensity(0) {}
+
+QPDensity ChargedGasDensityGrid::getDensity(const Vector3QLength &pos) const {
+	if (grid.isInside(pos)) return QPDensity(grid.interpolate(pos));
+	if (model) return model->getDensity(pos);
+	return QPDensity(0);
+}
+
+}}  // namespace hermes::chargedgas
@@ -1,5 +1,7 @@
 #include "hermes/chargedgas/YMW16.h"
 
+#include <algorithm>
+
 /*Copyright (C) 2016, 2017  J. M. Yao, R. N. Manchester, N. Wang.
 
 This file is part of the YMW16 program. YMW16 is a model for the
@@ -31,9 +33,20 @@ by Andrej Dundovic (andrej.dundovic@gssi.it, 2020)
 
 namespace hermes { namespace chargedgas {
 
-YMW16::YMW16() : ChargedGasDensity(1e4_K) { initParameters(); }
+YMW16::YMW16() : ChargedGasDensity(1e4_K), cullingEnabled(true) {
+	initParameters();
+}
+
+YMW16::YMW16(const QTemperature &t)
+    : ChargedGasDensity(t), cullingEnabled(true) {
+	initParameters();
+}
+
+void YMW16::enableCulling() { cullingEnabled = true; }
 
-YMW16::YMW16(const QTemperature &t) : ChargedGasDensity(t) { initParameters(); }
+void YMW16::disableCulling() { cullingEnabled = false; }
+
+bool YMW16::isCullingEnabled() const { return cullingEnabled; }
 
 QPDensity YMW16::getDensity(const Vector3QLength &pos) const {
 	auto conversion = [](QLength x) { return static_cast<double>(x / parsec); };
@@ -51,6 +64,26 @@ QPDensity YMW16::getDensity(const Vector3QLength &pos) const {
 	return density;
 };
 
+void YMW16::getDensities(const std::vector<Vector3QLength> &positions,
+                         std::vector<QPDensity> &densities) const {
+	auto conversion = [](QLength x) { return static_cast<double>(x / parsec); };
+
+	// the same change of coordinates as in getDensity()
+	std::vector<Vector3QLength> ymw16Positions;
+	ymw16Positions.reserve(positions.size());
+	for (const auto &pos : positions)
+		ymw16Positions.push_back(Vector3QLength(-1 * conversion(pos.getY()),
+		                                        conversion(pos.getX()),
+		                                        conversion(pos.getZ())));
+
+	std::vector<double> ne;
+	ne_ymw16(ymw16Positions, ne);
+
+	densities.resize(positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+		densities[i] = QPDensity(ne[i]) / 1_cm3 * 1_m3;
+}
+
 void YMW16::initParameters() {
 	t0 = {
 	    .Gamma_w = P_Gamma_w,
@@ -221,6 +254,9 @@ double YMW16::spiral(double xx, double yy, double zz, double gd, double rr,
 	Hg = 32 + 0.0016 * rr + 0.0000004 * std::pow(rr, 2);
 	HH = t3.Ka * Hg;
 
+	// every arm either is out of reach or ends in the zero return below
+	if (cullingEnabled && (gd == 0 || std::fabs(zz) > (mc * HH))) return 0;
+
 	if (*ww == 1) {
 		rmin[0] = sp_1_1;
 		thmin[0] = sp_1_2;
@@ -411,6 +447,19 @@ double YMW16::gum(double xx, double yy, double zz, int *m_5) const {
 	yc = R0 * 1000 - rgalc * clc;
 	zc = dc * sbc;
 
+	// Dmin is |RR - rp| times the sine of the angle between the radius and
+	// the tangent of the spheroid, which is at least 2K/(1+K^2) for the
+	// semi-axes Agn and Agn*K, and rp <= max(Agn, Agn*K). Beyond this
+	// bounding sphere Dmin > mc*Wgn for every K > 0
+	RR = (xx - xc) * (xx - xc) + (yy - yc) * (yy - yc) +
+	     (zz - zc) * (zz - zc);
+	if (cullingEnabled && t5.Kgn > 0) {
+		const double Rcull =
+		    std::max(t5.Agn, t5.Agn * t5.Kgn) +
+		    mc * t5.Wgn * (1 + t5.Kgn * t5.Kgn) / (2 * t5.Kgn);
+		if (RR > Rcull * Rcull) return 0;
+	}
+
 	theta = std::fabs(std::atan(
 	    (zz - zc) / std::sqrt((xx - xc) * (xx - xc) + (yy - yc) * (yy - yc))));
 	zp = ((t5.Agn) * (t5.Agn) * (t5.Kgn)) /
@@ -425,8 +474,7 @@ double YMW16::gum(double xx, double yy, double zz, int *m_5) const {
 		    -std::atan((-(t5.Agn) * (t5.Kgn) * xyp) /
 		               ((t5.Agn) * std::sqrt((t5.Agn) * (t5.Agn) - xyp * xyp)));
 	}
-	RR = std::sqrt((xx - xc) * (xx - xc) + (yy - yc) * (yy - yc) +
-	               (zz - zc) * (zz - zc));
+	RR = std::sqrt(RR);
 	rp = std::sqrt((zp) * (zp) + (xyp) * (xyp));
 	Dmin = std::fabs((RR - rp) * sin(theta + alpha));
 
@@ -527,11 +575,16 @@ double YMW16::nps(double xx, double yy, double zz, int *WLI, int *m_7) const {
 	double rr, theta;
 	rr = std::sqrt((xx - x_c) * (xx - x_c) + (yy - y_c) * (yy - y_c) +
 	               (zz - z_c) * (zz - z_c));
+	*WLI = 1;
+	// outside of the shell, the angular test is not needed
+	if (cullingEnabled && std::fabs(rr - t7.RLI) > (mc * t7.WLI)) {
+		if (rr > 500) (*m_7)++;
+		return 0;
+	}
 	theta = std::acos(((xx - x_c) * (std::cos(theta_LI)) +
 	                   (zz - z_c) * (std::sin(theta_LI))) /
 	                  rr) *
 	        RAD;
-	*WLI = 1;
 	if (std::fabs(rr - t7.RLI) > (mc * t7.WLI) ||
 	    std::fabs(theta) > (mc * t7.detthetaLI)) {
 		if (rr > 500) (*m_7)++;
@@ -739,11 +792,47 @@ double YMW16::smc(double xx, double yy, double zz, int *w_smc) const {
 	return (t11.nsmc) * gsmc * exp(-(Rsmc * Rsmc) / (Asmc * Asmc));
 }
 
+bool YMW16::outsideLocalBubble(double xx, double yy, double zz) const {
+	// the same distance UU from the bubble axis as in localbubble()
+	double UU = sqrt(((yy - 8340) * 0.94 - 0.34 * zz) *
+	                     ((yy - 8340) * 0.94 - 0.34 * zz) +
+	                 xx * xx);
+	return ((UU - Rlb) > (mc * t6.wlb1) || std::fabs(zz) > (mc * t6.hlb1)) &&
+	       ((UU - Rlb) > (mc * t6.wlb2) || std::fabs(zz) > (mc * t6.hlb2));
+}
+
 double YMW16::ne_ymw16(const Vector3QLength &pos) const {
 	double x = static_cast<double>(pos.getX());
 	double y = static_cast<double>(pos.getY());
 	double z = static_cast<double>(pos.getZ());
 
+	return ne_ymw16(x, y, z, static_cast<double>(pos.getRho()),
+	                static_cast<double>(pos.getR()));
+}
+
+void YMW16::ne_ymw16(const std::vector<Vector3QLength> &positions,
+                     std::vector<double> &ne) const {
+	const std::size_t n = positions.size();
+	std::vector<double> x(n), y(n), z(n), rr(n), R_g(n);
+
+	for (std::size_t i = 0; i < n; ++i) {
+		x[i] = static_cast<double>(positions[i].getX());
+		y[i] = static_cast<double>(positions[i].getY());
+		z[i] = static_cast<double>(positions[i].getZ());
+	}
+	// branch-free over contiguous arrays, so the compiler vectorises it
+	for (std::size_t i = 0; i < n; ++i) {
+		rr[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+		R_g[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+	}
+
+	ne.resize(n);
+	for (std::size_t i = 0; i < n; ++i)
+		ne[i] = ne_ymw16(x[i], y[i], z[i], rr[i], R_g[i]);
+}
+
+double YMW16::ne_ymw16(double x, double y, double z, double rr,
+                       double R_g) const {
 	double ne = 0;
 
 	double ne8 = 0;
@@ -754,8 +843,6 @@ double YMW16::ne_ymw16(const Vector3QLength &pos) const {
 	double xx, yy, zz, glr, gbr, dist;
 	double x_s, y_s, z_s, ll, bb, hh, r, sl, cl, sb, cb;
 
-	double rr = static_cast<double>(pos.getRho());
-	double R_g = static_cast<double>(pos.getR());
 	double gd = 0;
 
 	// The localtion of Sun relative to GP and Warp
@@ -779,6 +866,9 @@ double YMW16::ne_ymw16(const Vector3QLength &pos) const {
 	int w_lmc = 0;
 	int w_smc = 0;
 
+	// The point is located outside of MW and MC
+	if (cullingEnabled && R_g >= 100000) return 0;
+
 	xx = x;
 	yy = y;
 	zz = z;
@@ -791,23 +881,27 @@ double YMW16::ne_ymw16(const Vector3QLength &pos) const {
 	dist = sqrt(x_s * x_s + y_s * y_s + z_s * z_s);
 	r = sqrt(x_s * x_s + y_s * y_s);
 
-	if (dist < 1e-15) {
-		gbr = 0;
-	} else {
-		gbr = asin(z_s / dist);
-	}
-	gb = gbr * RAD;
+	// (gl, gb) are used by the Magellanic Clouds and the local bubble only
+	gbr = glr = gb = gl = 0;
+	if (!cullingEnabled || R_g > 30000 || !outsideLocalBubble(xx, yy, zz)) {
+		if (dist < 1e-15) {
+			gbr = 0;
+		} else {
+			gbr = asin(z_s / dist);
+		}
+		gb = gbr * RAD;
 
-	if (r < 1e-15) {
-		glr = 0;
-	} else {
-		if (x_s >= 0) {
-			glr = std::acos(-y_s / r);
+		if (r < 1e-15) {
+			glr = 0;
 		} else {
-			glr = std::acos(y_s / r) + pi;
+			if (x_s >= 0) {
+				glr = std::acos(-y_s / r);
+			} else {
+				glr = std::acos(y_s / r) + pi;
+			}
 		}
+		gl = glr * RAD;
 	}
-	gl = glr * RAD;
 	dd = dist;
 
 	/* Definition of warp */
@@ -7,7 +7,9 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "hermes/Common.h"
@@ -15,6 +17,9 @@
 #define DEFAULT_CR_FILE \
 	"CosmicRays/Fornieri20/run2d_gamma_D03,7_delta0,45_vA13.fits.gz"
 
+// number of values read from the FITS file at once
+#define SLAB_ELEMENTS (1 << 22)
+
 namespace hermes { namespace cosmicrays {
 
 Dragon2D::Dragon2D(const std::string &filename_, const PID &pid_)
@@ -37,6 +42,24 @@ Dragon2D::Dragon2D(const std::string &filename_, const std::vector<PID> &pids_)
 	readFile();
 }
 
+Dragon2D::Dragon2D(const std::string &filename_, const std::vector<PID> &pids_,
+                   const QEnergy &Emin_, const QEnergy &Emax_)
+    : CosmicRayDensity(pids_), filename(filename_), Emin(Emin_), Emax(Emax_) {
+	readFile();
+}
+
+Dragon2D::Dragon2D(const std::string &filename_,
+                   const std::map<PID, double> &weights_, const QEnergy &Emin_,
+                   const QEnergy &Emax_)
+    : filename(filename_), Emin(Emin_), Emax(Emax_) {
+	if (weights_.empty())
+		throw std::runtime_error("Dragon2D: no species weights given");
+	projectileWeights = weights_;
+	setOfPIDs.clear();
+	for (const auto &w : projectileWeights) enablePID(w.first);
+	readFile();
+}
+
 void Dragon2D::readFile() {
 	ffile = std::make_unique<FITSFile>(FITSFile(filename));
 
@@ -52,18 +75,34 @@ void Dragon2D::readFile() {
 
 QPDensityPerEnergy Dragon2D::getDensityPerEnergy(
     const QEnergy &E_, const Vector3QLength &pos_) const {
-	return getDensityPerEnergy(static_cast<int>(energyIndex.at(E_)), pos_);
+	std::size_t iE = getIndexOfE(E_);
+	if (iE == energyRange.size())
+		throw std::out_of_range(
+		    "Dragon2D: energy is not on the energy axis of the model");
+	return getDensityPerEnergy(iE, pos_);
 }
 
 QPDensityPerEnergy Dragon2D::getDensityPerEnergy(
-    int iE_, const Vector3QLength &pos_) const {
+    std::size_t iE_, const Vector3QLength &pos_) const {
 	if (pos_.z < zmin || pos_.z > zmax) return QPDensityPerEnergy(0);
 
 	QLength rho = sqrt(pos_.x * pos_.x + pos_.y * pos_.y);
 	if (rho > rmax) return QPDensityPerEnergy(0);
 
 	auto pos = Vector3QLength(rho, pos_.z, 0);
-	return (grid[iE_])->interpolate(pos);
+	return grid->interpolate(static_cast<Vector3d>(pos), iE_);
+}
+
+void Dragon2D::getSpectrum(const Vector3QLength &pos_,
+                          std::vector<QPDensityPerEnergy> &spectrum) const {
+	QLength rho = sqrt(pos_.x * pos_.x + pos_.y * pos_.y);
+	if (pos_.z < zmin || pos_.z > zmax || rho > rmax) {
+		spectrum.assign(energyRange.size(), QPDensityPerEnergy(0));
+		return;
+	}
+
+	auto pos = Vector3QLength(rho, pos_.z, 0);
+	grid->getSpectrum(static_cast<Vector3d>(pos), spectrum);
 }
 
 void Dragon2D::readEnergyAxis() {
@@ -72,13 +111,25 @@ void Dragon2D::readEnergyAxis() {
 	dimE = ffile->readKeyValueAsInt("dimE");
 	energyScaleFactor = ffile->readKeyValueAsDouble("Ekin_fac");
 
-	// input files are in GeV
+	// input files are in GeV; only the bins inside the energy window and
+	// their direct neighbours are kept
+	tEnergyRange fileRange;
 	for (int i = 0; i < dimE; ++i) {
 		E = 1_GeV * std::exp(std::log(Ekmin) + static_cast<double>(i) *
 		                                           std::log(energyScaleFactor));
-		energyRange.push_back(E);
-		energyIndex[E] = i;
+		fileRange.push_back(E);
 	}
+	auto first = std::lower_bound(fileRange.begin(), fileRange.end(), Emin);
+	auto last = std::upper_bound(first, fileRange.end(), Emax);
+	if (first == last)
+		throw std::runtime_error(
+		    "Dragon2D: no energy bin of " + filename +
+		    " lies inside the requested energy window");
+	if (first != fileRange.begin()) --first;
+	if (last != fileRange.end()) ++last;
+
+	iEmin = first - fileRange.begin();
+	energyRange.assign(first, last);
 }
 
 void Dragon2D::readSpatialGrid2D() {
@@ -100,27 +151,48 @@ void Dragon2D::readSpatialGrid2D() {
 	Vector3d spacing(static_cast<double>(deltar), static_cast<double>(deltaz),
 	                 0);
 
-	for (int i = 0; i < dimE; ++i) {
-		grid.push_back(std::make_unique<ScalarGrid2DQPDensityPerEnergy>(
-		    ScalarGrid2DQPDensityPerEnergy(origin, dimr, dimz, spacing)));
-	}
+	grid = std::make_unique<SpectralGrid2DQPDensityPerEnergy>(
+	    origin, dimr, dimz, energyRange.size(), spacing);
 }
 
 std::size_t Dragon2D::calcArrayIndex2D(std::size_t iE, std::size_t ir,
-                                       std::size_t iz) {
+                                       std::size_t iz) const {
 	return (iz * dimr + ir) * dimE + iE;
 }
 
+void Dragon2D::scatterSlab(std::size_t iz0, std::size_t nz,
+                           const std::vector<float> &slab, double weight) {
+	const double fluxToDensity =
+	    weight * static_cast<double>(4_pi / (c_light * 1_GeV));
+
+	// every thread fills its own range of r
+	std::size_t nE = energyRange.size();
+	auto scatter = [this, iz0, nz, nE, fluxToDensity, &slab](
+	                   std::size_t ir0, std::size_t ir1) {
+		for (std::size_t ir = ir0; ir < ir1; ++ir)
+			for (std::size_t iz = 0; iz < nz; ++iz) {
+				const float *v = &slab[calcArrayIndex2D(iEmin, ir, iz)];
+				for (std::size_t iE = 0; iE < nE; ++iE)
+					grid->addValue(ir, iz0 + iz, iE, fluxToDensity * v[iE]);
+			}
+	};
+
+	auto job_chunks = getThreadChunks(dimr);
+	std::vector<std::thread> threads;
+	threads.reserve(job_chunks.size());
+	for (auto &c : job_chunks)
+		threads.push_back(std::thread(scatter, c.first, c.second));
+	for (auto &t : threads) t.join();
+}
+
 void Dragon2D::readDensity2D() {
 	int hduIndex = 2;
 	int hduActual = 0;
-	int hdu_type = 0;
-	unsigned long firstElement = 1;
 
-	auto vecSize = dimr * dimz;
-	unsigned long nElements = energyRange.size() * vecSize;
-	constexpr double fluxToDensity =
-	    static_cast<double>(4_pi / (c_light * 1_GeV));
+	// the image holds dimz planes of dimr*dimE values with E running fastest
+	std::size_t planeSize = dimE * dimr;
+	std::size_t planesPerSlab =
+	    std::max<std::size_t>(1, SLAB_ELEMENTS / planeSize);
 
 	auto hduNumber = ffile->getNumberOfHDUs();
 	while (hduActual < hduNumber) {
@@ -141,18 +213,15 @@ void Dragon2D::readDensity2D() {
 			std::cerr << "hermes: info: reading species with Z = " << Z
 			          << " A = " << A << " at HDU = " << hduActual << std::endl;
 
-			std::vector<float> rawData =
-			    ffile->readImageAsFloat(firstElement, nElements);
-			for (std::size_t iE = 0; iE < dimE; ++iE) {
-				for (std::size_t ir = 0; ir < dimr; ++ir) {
-					for (std::size_t iz = 0; iz < dimz; ++iz) {
-						grid[iE]->addValue(
-						    ir, iz,
-						    fluxToDensity *
-						        rawData[calcArrayIndex2D(iE, ir, iz)]);
-					}
-				}
-			}
+			double weight = isProjectileWeighted()
+			                    ? projectileWeights.at(PID(Z, A))
+			                    : 1;
+			ffile->readImageInSlabs(
+			    planeSize, dimz, planesPerSlab,
+			    [this, weight](std::size_t iz0, std::size_t nz,
+			                   const std::vector<float> &slab) {
+				    scatterSlab(iz0, nz, slab, weight);
+			    });
 		}
 		hduIndex++;
 	}
@@ -7,7 +7,9 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "hermes/Common.h"
@@ -15,6 +17,9 @@
 #define DEFAULT_CR_FILE \
 	"CosmicRays/Fornieri20/run2d_gamma_D03,7_delta0,45_vA13.fits.gz"
 
+// number of values read from the FITS file at once
+#define SLAB_ELEMENTS (1 << 22)
+
 namespace hermes { namespace cosmicrays {
 
 Dragon3D::Dragon3D(const std::string &filename_, const PID &pid_)
@@ -27,6 +32,24 @@ Dragon3D::Dragon3D(const std::string &filename_, const std::vector<PID> &pids_)
 	readFile();
 }
 
+Dragon3D::Dragon3D(const std::string &filename_, const std::vector<PID> &pids_,
+                   const QEnergy &Emin_, const QEnergy &Emax_)
+    : CosmicRayDensity(pids_), filename(filename_), Emin(Emin_), Emax(Emax_) {
+	readFile();
+}
+
+Dragon3D::Dragon3D(const std::string &filename_,
+                   const std::map<PID, double> &weights_, const QEnergy &Emin_,
+                   const QEnergy &Emax_)
+    : filename(filename_), Emin(Emin_), Emax(Emax_) {
+	if (weights_.empty())
+		throw std::runtime_error("Dragon3D: no species weights given");
+	projectileWeights = weights_;
+	setOfPIDs.clear();
+	for (const auto &w : projectileWeights) enablePID(w.first);
+	readFile();
+}
+
 void Dragon3D::readFile() {
 	ffile = std::make_unique<FITSFile>(FITSFile(filename));
 
@@ -42,17 +65,32 @@ void Dragon3D::readFile() {
 
 QPDensityPerEnergy Dragon3D::getDensityPerEnergy(
     const QEnergy &E_, const Vector3QLength &pos_) const {
-	return getDensityPerEnergy(static_cast<int>(energyIndex.at(E_)), pos_);
+	std::size_t iE = getIndexOfE(E_);
+	if (iE == energyRange.size())
+		throw std::out_of_range(
+		    "Dragon3D: energy is not on the energy axis of the model");
+	return getDensityPerEnergy(iE, pos_);
 }
 
 QPDensityPerEnergy Dragon3D::getDensityPerEnergy(
-    int iE_, const Vector3QLength &pos_) const {
+    std::size_t iE_, const Vector3QLength &pos_) const {
 	if (pos_.z < zmin || pos_.z > zmax) return QPDensityPerEnergy(0);
 
 	QLength rho = sqrt(pos_.x * pos_.x + pos_.y * pos_.y);
 	if (rho > rmax) return QPDensityPerEnergy(0);
 
-	return (grid[iE_])->interpolate(pos_);
+	return grid->interpolate(static_cast<Vector3d>(pos_), iE_);
+}
+
+void Dragon3D::getSpectrum(const Vector3QLength &pos_,
+                          std::vector<QPDensityPerEnergy> &spectrum) const {
+	QLength rho = sqrt(pos_.x * pos_.x + pos_.y * pos_.y);
+	if (pos_.z < zmin || pos_.z > zmax || rho > rmax) {
+		spectrum.assign(energyRange.size(), QPDensityPerEnergy(0));
+		return;
+	}
+
+	grid->getSpectrum(static_cast<Vector3d>(pos_), spectrum);
 }
 
 void Dragon3D::readEnergyAxis() {
@@ -61,13 +99,25 @@ void Dragon3D::readEnergyAxis() {
 	dimE = ffile->readKeyValueAsInt("dimE");
 	energyScaleFactor = ffile->readKeyValueAsDouble("Ekin_fac");
 
-	// input files are in GeV
+	// input files are in GeV; only the bins inside the energy window and
+	// their direct neighbours are kept
+	tEnergyRange fileRange;
 	for (int i = 0; i < dimE; ++i) {
 		E = 1_GeV * std::exp(std::log(Ekmin) + static_cast<double>(i) *
 		                                           std::log(energyScaleFactor));
-		energyRange.push_back(E);
-		energyIndex[E] = i;
+		fileRange.push_back(E);
 	}
+	auto first = std::lower_bound(fileRange.begin(), fileRange.end(), Emin);
+	auto last = std::upper_bound(first, fileRange.end(), Emax);
+	if (first == last)
+		throw std::runtime_error(
+		    "Dragon3D: no energy bin of " + filename +
+		    " lies inside the requested energy window");
+	if (first != fileRange.begin()) --first;
+	if (last != fileRange.end()) ++last;
+
+	iEmin = first - fileRange.begin();
+	energyRange.assign(first, last);
 }
 
 void Dragon3D::readSpatialGrid3D() {
@@ -92,22 +142,47 @@ void Dragon3D::readSpatialGrid3D() {
 	Vector3d spacing(static_cast<double>(deltax), static_cast<double>(deltay),
 	                 static_cast<double>(deltaz));
 
-	for (int i = 0; i < dimE; ++i) {
-		grid.push_back(std::make_unique<ScalarGridQPDensityPerEnergy>(
-		    ScalarGridQPDensityPerEnergy(origin, dimx, dimy, dimz, spacing)));
-	}
+	grid = std::make_unique<SpectralGridQPDensityPerEnergy>(
+	    origin, dimx, dimy, dimz, energyRange.size(), spacing);
+}
+
+void Dragon3D::scatterSlab(std::size_t iz0, std::size_t nz,
+                           const std::vector<float> &slab, double weight) {
+	const double fluxToDensity =
+	    weight * static_cast<double>(4_pi / (c_light * 1_GeV));
+
+	// every thread fills its own range of x
+	std::size_t nE = energyRange.size();
+	auto scatter = [this, iz0, nz, nE, fluxToDensity, &slab](
+	                   std::size_t ix0, std::size_t ix1) {
+		for (std::size_t ix = ix0; ix < ix1; ++ix)
+			for (std::size_t iy = 0; iy < dimy; ++iy)
+				for (std::size_t iz = 0; iz < nz; ++iz) {
+					const float *v =
+					    &slab[((iz * dimy + iy) * dimx + ix) * dimE + iEmin];
+					for (std::size_t iE = 0; iE < nE; ++iE)
+						grid->addValue(ix, iy, iz0 + iz, iE,
+						               fluxToDensity * v[iE]);
+				}
+	};
+
+	auto job_chunks = getThreadChunks(dimx);
+	std::vector<std::thread> threads;
+	threads.reserve(job_chunks.size());
+	for (auto &c : job_chunks)
+		threads.push_back(std::thread(scatter, c.first, c.second));
+	for (auto &t : threads) t.join();
 }
 
 void Dragon3D::readDensity3D() {
 	int hduIndex = 2;
 	int hduActual = 0;
-	int hdu_type = 0;
-	unsigned long firstElement = 1;
 
-	auto vecSize = dimx * dimy * dimz;
-	unsigned long nElements = energyRange.size() * vecSize;
-	constexpr double fluxToDensity =
-	    static_cast<double>(4_pi / (c_light * 1_GeV));
+	// the image holds dimz planes of dimx*dimy*dimE values with E running
+	// fastest, then x and y
+	std::size_t planeSize = dimE * dimx * dimy;
+	std::size_t planesPerSlab =
+	    std::max<std::size_t>(1, SLAB_ELEMENTS / planeSize);
 
 	auto hduNumber = ffile->getNumberOfHDUs();
 	while (hduActual < hduNumber) {
@@ -128,28 +203,15 @@ void Dragon3D::readDensity3D() {
 			std::cerr << "... reading species with Z = " << Z << " A = " << A
 			          << " at HDU = " << hduActual << std::endl;
 
-			std::vector<float> rawData =
-			    ffile->readImageAsFloat(firstElement, nElements);
-
-			std::size_t iE, ix, iy, iz;
-			std::div_t dv;
-			for (auto it = rawData.begin(); it != rawData.end(); ++it) {
-				std::size_t index = it - rawData.begin();
-
-				dv = std::div(index, dimE);
-				iE = dv.rem;
-				dv = std::div(dv.quot, dimx);
-				ix = dv.rem;
-				dv = std::div(dv.quot, dimy);
-				iy = dv.rem;
-				dv = std::div(dv.quot, dimz);
-				iz = dv.rem;
-
-				(*it) *= fluxToDensity;
-
-				grid[iE]->addValue(ix, iy, iz,
-				                   static_cast<QPDensityPerEnergy>(*it));
-			}
+			double weight = isProjectileWeighted()
+			                    ? projectileWeights.at(PID(Z, A))
+			                    : 1;
+			ffile->readImageInSlabs(
+			    planeSize, dimz, planesPerSlab,
+			    [this, weight](std::size_t iz0, std::size_t nz,
+			                   const std::vector<float> &slab) {
+				    scatterSlab(iz0, nz, slab, weight);
+			    });
 		}
 		hduIndex++;
 	}
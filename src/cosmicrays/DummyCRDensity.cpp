@@ -22,6 +22,7 @@ void DummyCRDensity::makeEnergyRange() {
 	QEnergy energy = minE;
 	double energyRatio =
 	    exp(1. / static_cast<double>(steps - 1) * log(maxE / minE));
+	energyScaleFactor = energyRatio;
 
 	for (int i = 0; i < steps; ++i) {
 		energyRange.push_back(energy);
@@ -5,12 +5,14 @@ namespace hermes { namespace cosmicrays {
 SimpleCRDensity::SimpleCRDensity(const PID &pid_)
     : CosmicRayDensity(pid_), minE(1_GeV), maxE(10_TeV), steps(20) {
 	makeEnergyRange();
+	cacheSpectralShape();
 }
 
 SimpleCRDensity::SimpleCRDensity(const PID &pid_, QEnergy minE_, QEnergy maxE_,
                                  int steps_)
     : CosmicRayDensity(pid_), minE(minE_), maxE(maxE_), steps(steps_) {
 	makeEnergyRange();
+	cacheSpectralShape();
 }
 
 void SimpleCRDensity::makeEnergyRange() {
@@ -26,16 +28,20 @@ void SimpleCRDensity::makeEnergyRange() {
 
 QPDensityPerEnergy SimpleCRDensity::getDensityPerEnergy(
     const QEnergy &E_, const Vector3QLength &pos_) const {
+	return getSpatialProfile(pos_) * getSpectralShape(E_);
+}
+
+QPDensityPerEnergy SimpleCRDensity::getSpectralShape(const QEnergy &E_) const {
 	constexpr int alpha = 3;
 	auto Phi0 = 0.1 / (1_GeV * 1_cm * 1_cm * 1_s * c_light) * 4_pi;
 	auto E0 = 1_GeV;
 	auto E_cutoff = 5_TeV;
 
-	QNumber profile = exp(-1. * fabs(pos_.getZ()) / 1_kpc);
-	QPDensityPerEnergy spectrum =
-	    Phi0 * pow<-1 * alpha>(E_ / E0) * exp(-E_ / E_cutoff);
+	return Phi0 * pow<-1 * alpha>(E_ / E0) * exp(-E_ / E_cutoff);
+}
 
-	return profile * spectrum;
+QNumber SimpleCRDensity::getSpatialProfile(const Vector3QLength &pos_) const {
+	return exp(-1. * fabs(pos_.getZ()) / 1_kpc);
 }
 
 }}  // namespace hermes::cosmicrays
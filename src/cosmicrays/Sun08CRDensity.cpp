@@ -7,12 +7,14 @@ namespace hermes { namespace cosmicrays {
 Sun08CRDensity::Sun08CRDensity() : minE(1_GeV), maxE(1e4_GeV), steps(10) {
 	makeEnergyRange();
 	setParameters();
+	cacheSpectralShape();
 }
 
 Sun08CRDensity::Sun08CRDensity(QEnergy minE_, QEnergy maxE_, int steps_)
     : minE(minE_), maxE(maxE_), steps(steps_) {
 	makeEnergyRange();
 	setParameters();
+	cacheSpectralShape();
 }
 
 void Sun08CRDensity::setParameters() {
@@ -28,6 +30,7 @@ void Sun08CRDensity::makeEnergyRange() {
 	QEnergy energy = minE;
 	double energyRatio =
 	    exp(1. / static_cast<double>(steps - 1) * log(maxE / minE));
+	energyScaleFactor = energyRatio;
 
 	for (int i = 0; i < steps; ++i) {
 		energyRange.push_back(energy);
@@ -37,17 +40,24 @@ void Sun08CRDensity::makeEnergyRange() {
 
 QPDensityPerEnergy Sun08CRDensity::getDensityPerEnergy(
     const QEnergy &E_, const Vector3QLength &pos_) const {
-	if (fabs(pos_.z) > 1_kpc) return QPDensityPerEnergy(0);
+	return getSpatialProfile(pos_) * getSpectralShape(E_);
+}
+
+QPDensityPerEnergy Sun08CRDensity::getSpectralShape(const QEnergy &E_) const {
+	return C_0 *
+	       std::pow(static_cast<double>(getLorentzFactor(m_electron, E_)),
+	                -spectralIndex) /
+	       (m_electron * c_squared);
+}
+
+QNumber Sun08CRDensity::getSpatialProfile(const Vector3QLength &pos_) const {
+	if (fabs(pos_.z) > 1_kpc) return QNumber(0);
 
 	QLength rho = sqrt(pos_.x * pos_.x + pos_.y * pos_.y);
 
 	if (rho < 3_kpc) rho = 3_kpc;
 
-	QNumber profile = exp(-(rho - r_Earth) / h_r - fabs(pos_.z) / h_d);
-	return C_0 * profile *
-	       std::pow(static_cast<double>(getLorentzFactor(m_electron, E_)),
-	                -spectralIndex) /
-	       (m_electron * c_squared);
+	return exp(-(rho - r_Earth) / h_r - fabs(pos_.z) / h_d);
 }
 
 }}  // namespace hermes::cosmicrays
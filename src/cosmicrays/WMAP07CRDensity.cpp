@@ -7,12 +7,14 @@ namespace hermes { namespace cosmicrays {
 WMAP07CRDensity::WMAP07CRDensity() : minE(1_GeV), maxE(1e4_GeV), steps(10) {
 	makeEnergyRange();
 	setParameters();
+	cacheSpectralShape();
 }
 
 WMAP07CRDensity::WMAP07CRDensity(QEnergy minE_, QEnergy maxE_, int steps_)
     : minE(minE_), maxE(maxE_), steps(steps_) {
 	makeEnergyRange();
 	setParameters();
+	cacheSpectralShape();
 }
 
 void WMAP07CRDensity::setParameters() {
@@ -30,6 +32,7 @@ void WMAP07CRDensity::makeEnergyRange() {
 	QEnergy energy = minE;
 	double energyRatio =
 	    exp(1. / static_cast<double>(steps - 1) * log(maxE / minE));
+	energyScaleFactor = energyRatio;
 
 	for (int i = 0; i < steps; ++i) {
 		energyRange.push_back(energy);
@@ -39,13 +42,20 @@ void WMAP07CRDensity::makeEnergyRange() {
 
 QPDensityPerEnergy WMAP07CRDensity::getDensityPerEnergy(
     const QEnergy &E_, const Vector3QLength &pos_) const {
-	QLength rho = sqrt(pos_.x * pos_.x + pos_.y * pos_.y);
+	return getSpatialProfile(pos_) * getSpectralShape(E_);
+}
 
-	QNumber profile = exp(-rho / h_r) / (std::pow(cosh(pos_.z / h_d), 2));
-	return C_0 * profile *
+QPDensityPerEnergy WMAP07CRDensity::getSpectralShape(const QEnergy &E_) const {
+	return C_0 *
 	       std::pow(static_cast<double>(getLorentzFactor(m_electron, E_)),
 	                -spectralIndex) /
 	       (m_electron * c_squared);
 }
 
+QNumber WMAP07CRDensity::getSpatialProfile(const Vector3QLength &pos_) const {
+	QLength rho = sqrt(pos_.x * pos_.x + pos_.y * pos_.y);
+
+	return exp(-rho / h_r) / (std::pow(cosh(pos_.z / h_d), 2));
+}
+
 }}  // namespace hermes::cosmicrays
@@ -24,53 +24,38 @@ BremsstrahlungIntegrator::BremsstrahlungIntegrator(
 
 BremsstrahlungIntegrator::~BremsstrahlungIntegrator() {}
 
-QPiZeroIntegral BremsstrahlungIntegrator::integrateOverEnergy(
-    const Vector3QLength &pos_, const QEnergy &Egamma_) const {
-	if (cacheTableInitialized) return getIOEfromCache(pos_, Egamma_);
-
-	auto crDensity = crList[0];
-
+BremsstrahlungIntegrator::tEnergyKernel
+BremsstrahlungIntegrator::computeEnergyKernel(
+    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+    const QEnergy &Egamma_) const {
 	// we have 3 targets: HI, HII and He
 	// the ring model has HI and H2 (CO)
 
 	// Not ionized
 
 	// brems = cs_HI + cs_He*He_abundance
-	std::vector<QDiffCrossSection> diffCrossSectionVector;
+	tEnergyKernel kernel;
 	std::transform(
 	    crDensity->beginAfterEnergy(Egamma_), crDensity->end(),
-	    std::back_inserter(diffCrossSectionVector),
-	    [this, Egamma_](const QEnergy &E) -> QDiffCrossSection {
-		    return (crossSecBrem->getDiffCrossSectionForTarget(
+	    std::back_inserter(kernel),
+	    [this, Egamma_](const QEnergy &E) -> QPiZeroKernel {
+		    return E *
+		           (crossSecBrem->getDiffCrossSectionForTarget(
 		                interactions::BremsstrahlungAbstract::Target::HI, E,
 		                Egamma_) +
 		            0.1 * crossSecBrem->getDiffCrossSectionForTarget(
 		                      interactions::BremsstrahlungAbstract::Target::He,
-		                      E, Egamma_));
+		                      E, Egamma_)) *
+		           c_light;
 	    });
+	return kernel;
+}
 
-	auto pid_projectile = crDensity->getPID();
-
-	std::vector<QPDensity> cosmicRayVector;
-	std::transform(crDensity->beginAfterEnergy(Egamma_), crDensity->end(),
-	               std::back_inserter(cosmicRayVector),
-	               [crDensity, pos_](const QEnergy &E) -> QPDensity {
-		               return crDensity->getDensityPerEnergy(E, pos_) * E;
-	               });
-
-	std::vector<QPiZeroIntegral> integral;
-	std::transform(cosmicRayVector.begin(), cosmicRayVector.end(),
-	               diffCrossSectionVector.begin(), std::back_inserter(integral),
-	               [](const QPDensity &a, const QDiffCrossSection &b) {
-		               return a * b * c_light;
-	               });
-
-	// log-integration
-	auto integralOverEnergy =
-	    std::log(crDensity->getEnergyScaleFactor()) *
-	    std::accumulate(integral.begin(), integral.end(), QPiZeroIntegral(0));
-
-	return integralOverEnergy;
+QPiZeroIntegral BremsstrahlungIntegrator::integrateOverEnergy(
+    const Vector3QLength &pos_, const QEnergy &Egamma_,
+    const tEnergyKernels &kernels) const {
+	return integrateSpectrum(crList[0], pos_, Egamma_,
+	                         kernels[kernelIndex[0]]);
 }
 
 }  // namespace hermes
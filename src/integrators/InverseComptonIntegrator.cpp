@@ -6,6 +6,7 @@
 #include <mutex>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
 #include "hermes/Common.h"
 #include "hermes/Signals.h"
@@ -27,10 +28,11 @@ InverseComptonIntegrator::~InverseComptonIntegrator() {}
 void InverseComptonIntegrator::computeCacheInThread(
     std::size_t start, std::size_t end, const QEnergy &Egamma,
     std::shared_ptr<ProgressBar> &p) {
+	auto kernels = getKernels(Egamma);
 	for (std::size_t i = start; i < end; ++i) {
 		auto pos =
 		    static_cast<Vector3QLength>(cacheTable->positionFromIndex(i));
-		cacheTable->get(i) = this->integrateOverEnergy(pos, Egamma);
+		cacheTable->get(i) = this->integrateOverEnergy(pos, Egamma, kernels);
 		p->update();
 	}
 }
@@ -96,9 +98,14 @@ QDiffIntensity InverseComptonIntegrator::integrateOverLOS(
 
 QDiffIntensity InverseComptonIntegrator::integrateOverLOS(
     const QDirection &direction_, const QEnergy &Egamma_) const {
-	auto integrand = [this, direction_, Egamma_](const QLength &dist) {
-		return this->integrateOverEnergy(
-		    getGalacticPosition(getSunPosition(), dist, direction_), Egamma_);
+	tKernels kernels;
+	if (!cacheTableInitialized) kernels = getKernels(Egamma_);
+	auto integrand = [this, direction_, Egamma_,
+	                  &kernels](const QLength &dist) {
+		auto pos = getGalacticPosition(getSunPosition(), dist, direction_);
+		return (cacheTableInitialized)
+		           ? getIOEfromCache(pos, Egamma_)
+		           : this->integrateOverEnergy(pos, Egamma_, kernels);
 	};
 
 	return gslQAGIntegration<QDiffFlux, QGREmissivity>(
@@ -107,41 +114,235 @@ QDiffIntensity InverseComptonIntegrator::integrateOverLOS(
 	       (4_pi * 1_sr);
 }
 
+InverseComptonIntegrator::tSeparableKernel
+InverseComptonIntegrator::computeSeparableKernel(const QEnergy &Egamma_) const {
+	tSeparableKernel kernel(phdensity->end() - phdensity->begin(),
+	                        QICKernel(0));
+
+	for (auto itPh = std::next(phdensity->begin()); itPh != phdensity->end();
+	     ++itPh) {
+		decltype(QICKernel() * QEnergy()) integral(0);
+		if (crdensity->existsScaleFactor()) {
+			for (auto itE = crdensity->begin(); itE != crdensity->end(); ++itE)
+				integral += crossSec->getDiffCrossSection((*itE), (*itPh),
+				                                          Egamma_) *
+				            crdensity->getSpectralShape(*itE) * (*itE) *
+				            c_light;
+			integral = integral * log(crdensity->getEnergyScaleFactor());
+		} else {
+			for (auto itE = std::next(crdensity->begin());
+			     itE != crdensity->end(); ++itE) {
+				QEnergy deltaE = (*itE) - *std::prev(itE);
+				integral += crossSec->getDiffCrossSection((*itE), (*itPh),
+				                                          Egamma_) *
+				            crdensity->getSpectralShape(*itE) * c_light *
+				            deltaE;
+			}
+		}
+
+		// weights of the log-integration over photon energies
+		QNumber xlog = log((*itPh) / *std::prev(itPh));
+		kernel[itPh - phdensity->begin()] = integral * xlog / (*itPh);
+	}
+
+	return kernel;
+}
+
+InverseComptonIntegrator::tKernels InverseComptonIntegrator::getKernels(
+    const QEnergy &Egamma_) const {
+	tKernels kernels;
+	if (crdensity->isSeparable()) {
+		kernels.separable =
+		    separableKernel.get(Egamma_, [this](const QEnergy &E) {
+			    return computeSeparableKernel(E);
+		    });
+	} else if (phdensity->getNumberOfComponents() > 0) {
+		kernels.components = componentKernel.get(
+		    tComponentKey(Egamma_, phdensity->getComponentsVersion()),
+		    [this](const tComponentKey &key) {
+			    return computeComponentKernel(key.first);
+		    });
+	} else {
+		kernels.matrix = kernelMatrix.get(Egamma_, [this](const QEnergy &E) {
+			return computeKernelMatrix(E);
+		});
+	}
+	return kernels;
+}
+
 QGREmissivity InverseComptonIntegrator::integrateOverEnergy(
     const Vector3QLength &pos_, const QEnergy &Egamma_) const {
 	if (cacheTableInitialized) return getIOEfromCache(pos_, Egamma_);
 
+	return integrateOverEnergy(pos_, Egamma_, getKernels(Egamma_));
+}
+
+QGREmissivity InverseComptonIntegrator::integrateOverEnergy(
+    const Vector3QLength &pos_, const QEnergy &Egamma_,
+    const tKernels &kernels) const {
+	// separable models: the electron energy integral is done once per
+	// gamma-ray energy, what remains is a sum over photon energies
+	if (kernels.separable) {
+		QNumber profile = crdensity->getSpatialProfile(pos_);
+		if (profile == QNumber(0)) return QGREmissivity(0);
+
+		const tSeparableKernel &kernel = *kernels.separable;
+		// per-thread scratch buffer, it keeps its capacity between calls
+		thread_local std::vector<QEnergyDensity> photonSpectrum;
+		phdensity->getSpectrum(pos_, photonSpectrum);
+		QGREmissivity integral(0);
+		for (std::size_t j = 1; j < kernel.size(); ++j)
+			integral += kernel[j] * photonSpectrum[j];
+		return profile * integral;
+	}
+
 	if (crdensity->existsScaleFactor()) {
-		return integrateOverLogEnergy(pos_, Egamma_);
+		return integrateOverLogEnergy(pos_, kernels);
 	} else {
-		return integrateOverSumEnergy(pos_, Egamma_);
+		return integrateOverSumEnergy(pos_, kernels);
+	}
+}
+
+InverseComptonIntegrator::tKernelMatrix
+InverseComptonIntegrator::computeKernelMatrix(const QEnergy &Egamma_) const {
+	const std::size_t nPhoton = phdensity->end() - phdensity->begin();
+	tKernelMatrix kernel((crdensity->end() - crdensity->begin()) * nPhoton, 0);
+
+	// the same terms as in integrateOverPhotonEnergy(), without u_j
+	double *row = kernel.data();
+	for (auto itE = crdensity->begin(); itE != crdensity->end();
+	     ++itE, row += nPhoton) {
+		for (auto itPh = std::next(phdensity->begin());
+		     itPh != phdensity->end(); ++itPh) {
+			QNumber xlog = log((*itPh) / *std::prev(itPh));
+			row[itPh - phdensity->begin()] = static_cast<double>(
+			    crossSec->getDiffCrossSection((*itE), (*itPh), Egamma_) /
+			    (*itPh) * xlog);
+		}
+	}
+
+	return kernel;
+}
+
+InverseComptonIntegrator::tComponentKernel
+InverseComptonIntegrator::computeComponentKernel(const QEnergy &Egamma_) const {
+	auto matrix = kernelMatrix.get(Egamma_, [this](const QEnergy &E) {
+		return computeKernelMatrix(E);
+	});
+
+	const std::size_t nE = crdensity->end() - crdensity->begin();
+	const std::size_t nPhoton = phdensity->end() - phdensity->begin();
+	const std::size_t nComponents = phdensity->getNumberOfComponents();
+	tComponentKernel kernel(nE * nComponents);
+	for (std::size_t k = 0; k < nComponents; ++k) {
+		const auto &spectrum = phdensity->getComponentSpectrum(k);
+		for (std::size_t i = 0; i < nE; ++i) {
+			const double *row = matrix->data() + i * nPhoton;
+			double integral = 0;
+			for (std::size_t j = 0; j < nPhoton; ++j)
+				integral += row[j] * static_cast<double>(spectrum[j]);
+			kernel[i * nComponents + k] = QICInnerIntegral(integral);
+		}
+	}
+	return kernel;
+}
+
+void InverseComptonIntegrator::integrateOverPhotonEnergies(
+    const Vector3QLength &pos_, const tKernels &kernels,
+    std::vector<QICInnerIntegral> &integrals) const {
+	const std::size_t nE = crdensity->end() - crdensity->begin();
+	integrals.resize(nE);
+
+	// low-rank photon fields: a sum over the components per CR energy
+	if (kernels.components) {
+		const tComponentKernel &kernel = *kernels.components;
+		const std::size_t nComponents = phdensity->getNumberOfComponents();
+
+		// per-thread scratch buffer, it keeps its capacity between calls
+		thread_local std::vector<double> weights;
+		phdensity->getComponentWeights(pos_, weights);
+		for (std::size_t i = 0; i < nE; ++i) {
+			QICInnerIntegral integral(0);
+			for (std::size_t k = 0; k < nComponents; ++k)
+				integral += weights[k] * kernel[i * nComponents + k];
+			integrals[i] = integral;
+		}
+		return;
+	}
+
+	// dense matrix-vector product K u with the kernel matrix of Egamma,
+	// the spectrum and u are per-thread scratch buffers
+	thread_local std::vector<QEnergyDensity> photonSpectrum;
+	thread_local std::vector<double> u;
+	phdensity->getSpectrum(pos_, photonSpectrum);
+	const std::size_t nPhoton = photonSpectrum.size();
+	u.resize(nPhoton);
+	for (std::size_t j = 0; j < nPhoton; ++j)
+		u[j] = static_cast<double>(photonSpectrum[j]);
+
+	// u stays in L1, every row of K is streamed once; four rows at a time
+	// share the loads of u, the dot products are vectorised by the compiler
+	const double *K = kernels.matrix->data();
+	const double *u_ = u.data();
+	std::size_t i = 0;
+	for (; i + 4 <= nE; i += 4) {
+		const double *k0 = K + i * nPhoton, *k1 = k0 + nPhoton;
+		const double *k2 = k1 + nPhoton, *k3 = k2 + nPhoton;
+		double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+		for (std::size_t j = 0; j < nPhoton; ++j) {
+			s0 += k0[j] * u_[j];
+			s1 += k1[j] * u_[j];
+			s2 += k2[j] * u_[j];
+			s3 += k3[j] * u_[j];
+		}
+		integrals[i] = QICInnerIntegral(s0);
+		integrals[i + 1] = QICInnerIntegral(s1);
+		integrals[i + 2] = QICInnerIntegral(s2);
+		integrals[i + 3] = QICInnerIntegral(s3);
+	}
+	for (; i < nE; ++i) {
+		const double *k0 = K + i * nPhoton;
+		double s0 = 0;
+		for (std::size_t j = 0; j < nPhoton; ++j) s0 += k0[j] * u_[j];
+		integrals[i] = QICInnerIntegral(s0);
 	}
 }
 
 QGREmissivity InverseComptonIntegrator::integrateOverSumEnergy(
-    const Vector3QLength &pos_, const QEnergy &Egamma_) const {
+    const Vector3QLength &pos_, const tKernels &kernels) const {
 	QGREmissivity integral(0);
 	QEnergy deltaE;
 
+	// per-thread scratch buffers, they keep their capacity between calls
+	thread_local std::vector<QPDensityPerEnergy> spectrum;
+	thread_local std::vector<QICInnerIntegral> inner;
+	crdensity->getSpectrum(pos_, spectrum);
+	integrateOverPhotonEnergies(pos_, kernels, inner);
+	auto itN = std::next(spectrum.begin());
+	auto itI = std::next(inner.begin());
 	for (auto itE = std::next(crdensity->begin()); itE != crdensity->end();
-	     ++itE) {
+	     ++itE, ++itN, ++itI) {
 		deltaE = (*itE) - *std::prev(itE);
-		integral += integrateOverPhotonEnergy(pos_, Egamma_, (*itE)) *
-		            crdensity->getDensityPerEnergy(*itE, pos_) * c_light *
-		            deltaE;
+		integral += (*itI) * (*itN) * c_light * deltaE;
 	}
 
 	return integral;
 }
 
 QGREmissivity InverseComptonIntegrator::integrateOverLogEnergy(
-    const Vector3QLength &pos_, const QEnergy &Egamma_) const {
+    const Vector3QLength &pos_, const tKernels &kernels) const {
 	QGREmissivity integral(0);
 
-	for (auto itE = crdensity->begin(); itE != crdensity->end(); ++itE) {
-		integral += integrateOverPhotonEnergy(pos_, Egamma_, (*itE)) *
-		            crdensity->getDensityPerEnergy((*itE), pos_) * (*itE) *
-		            c_light;
+	// per-thread scratch buffers, they keep their capacity between calls
+	thread_local std::vector<QPDensityPerEnergy> spectrum;
+	thread_local std::vector<QICInnerIntegral> inner;
+	crdensity->getSpectrum(pos_, spectrum);
+	integrateOverPhotonEnergies(pos_, kernels, inner);
+	auto itN = spectrum.begin();
+	auto itI = inner.begin();
+	for (auto itE = crdensity->begin(); itE != crdensity->end();
+	     ++itE, ++itN, ++itI) {
+		integral += (*itI) * (*itN) * (*itE) * c_light;
 	}
 
 	return integral * log(crdensity->getEnergyScaleFactor());
@@ -149,16 +350,22 @@ QGREmissivity InverseComptonIntegrator::integrateOverLogEnergy(
 
 QICInnerIntegral InverseComptonIntegrator::integrateOverPhotonEnergy(
     const Vector3QLength &pos_, const QEnergy &Egamma_,
+    const QEnergy &Eelectron_) const {
+	std::vector<QEnergyDensity> photonSpectrum;
+	phdensity->getSpectrum(pos_, photonSpectrum);
+	return integrateOverPhotonEnergy(photonSpectrum, Egamma_, Eelectron_);
+}
+
+QICInnerIntegral InverseComptonIntegrator::integrateOverPhotonEnergy(
+    const std::vector<QEnergyDensity> &photonSpectrum, const QEnergy &Egamma_,
     const QEnergy &Eelectron_) const {
 	QICInnerIntegral integral(0);
 
-	auto integrand = [this, pos_, Egamma_, Eelectron_](
+	auto integrand = [this, &photonSpectrum, Egamma_, Eelectron_](
 	                     const cosmicrays::CosmicRayDensity::iterator itE,
 	                     const QEnergy &deltaE) {
 		return crossSec->getDiffCrossSection(Eelectron_, (*itE), Egamma_) *
-		       phdensity->getEnergyDensity(
-		           pos_, static_cast<std::size_t>(itE - phdensity->begin())) /
-		       pow<2>(*itE);
+		       photonSpectrum[itE - phdensity->begin()] / pow<2>(*itE);
 	};
 
 	for (auto itE = std::next(phdensity->begin()); itE != phdensity->end();
@@ -174,9 +381,13 @@ QICInnerIntegral InverseComptonIntegrator::integrateOverPhotonEnergy(
 
 InverseComptonIntegrator::tLOSProfile InverseComptonIntegrator::getLOSProfile(
     const QDirection &direction, const QEnergy &Egamma, int Nsteps) const {
-	auto integrand = [this, direction, Egamma](const QLength &dist) {
-		return this->integrateOverEnergy(
-		    getGalacticPosition(getSunPosition(), dist, direction), Egamma);
+	tKernels kernels;
+	if (!cacheTableInitialized) kernels = getKernels(Egamma);
+	auto integrand = [this, direction, Egamma, &kernels](const QLength &dist) {
+		auto pos = getGalacticPosition(getSunPosition(), dist, direction);
+		return (cacheTableInitialized)
+		           ? getIOEfromCache(pos, Egamma)
+		           : this->integrateOverEnergy(pos, Egamma, kernels);
 	};
 
 	QLength start = 0_m;
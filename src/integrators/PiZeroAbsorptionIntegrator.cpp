@@ -24,7 +24,10 @@ PiZeroAbsorptionIntegrator::PiZeroAbsorptionIntegrator(
           crDensity_}),
       ngdensity(ngdensity_),
       phdensity(phdensity_),
-      crossSec(crossSec_) {}
+      crossSec(crossSec_) {
+	checkProjectileWeights();
+	indexEnergyAxes();
+}
 
 PiZeroAbsorptionIntegrator::PiZeroAbsorptionIntegrator(
     const std::vector<std::shared_ptr<cosmicrays::CosmicRayDensity>> &crList_,
@@ -35,17 +38,42 @@ PiZeroAbsorptionIntegrator::PiZeroAbsorptionIntegrator(
       crList(crList_),
       ngdensity(ngdensity_),
       phdensity(phdensity_),
-      crossSec(crossSec_) {}
+      crossSec(crossSec_) {
+	checkProjectileWeights();
+	indexEnergyAxes();
+}
 
 PiZeroAbsorptionIntegrator::~PiZeroAbsorptionIntegrator() {}
 
+void PiZeroAbsorptionIntegrator::indexEnergyAxes() {
+	kernelIndex.clear();
+	kernelAxes.clear();
+	for (const auto &crDensity : crList) {
+		std::size_t k = 0;
+		while (k < kernelAxes.size() &&
+		       !crDensity->hasSameEnergyAxis(*kernelAxes[k]))
+			++k;
+		if (k == kernelAxes.size()) kernelAxes.push_back(crDensity);
+		kernelIndex.push_back(k);
+	}
+}
+
+void PiZeroAbsorptionIntegrator::checkProjectileWeights() const {
+	for (const auto &crDensity : crList)
+		if (crDensity->isProjectileWeighted())
+			crossSec->checkProjectileWeights(
+			    crDensity->getProjectileWeights(),
+			    ngdensity->getAbundanceFractions());
+}
+
 void PiZeroAbsorptionIntegrator::computeCacheInThread(
     std::size_t start, std::size_t end, const QEnergy &Egamma,
     std::shared_ptr<ProgressBar> &p) {
+	auto kernels = getEnergyKernels(Egamma);
 	for (std::size_t i = start; i < end; ++i) {
 		auto pos =
 		    static_cast<Vector3QLength>(cacheTable->positionFromIndex(i));
-		cacheTable->get(i) = this->integrateOverEnergy(pos, Egamma);
+		cacheTable->get(i) = this->integrateOverEnergy(pos, Egamma, *kernels);
 		p->update();
 	}
 }
@@ -127,7 +155,7 @@ QDiffIntensity PiZeroAbsorptionIntegrator::integrateOverLOS(
 		opticalDepthLOS.push_back(std::make_pair(dist, opticalDepth));
 	}
 
-	auto findOpticalDepth = [opticalDepthLOS](QLength s) -> QNumber {
+	auto findOpticalDepth = [&opticalDepthLOS](QLength s) -> QNumber {
 		auto t_pair = std::make_pair(s, 0);
 		auto pair = std::upper_bound(
 		    opticalDepthLOS.begin(), opticalDepthLOS.end(), t_pair,
@@ -150,16 +178,31 @@ QDiffIntensity PiZeroAbsorptionIntegrator::integrateOverLOS(
 	}
 	*/
 
+	// without the cache table the kernels are resolved once for all rings
+	std::shared_ptr<const tEnergyKernels> kernels;
+	if (!cacheTableInitialized) kernels = getEnergyKernels(Egamma_);
+	auto emissivity = [this, &kernels](const Vector3QLength &pos,
+	                                   const QEnergy &Egamma_) {
+		return (cacheTableInitialized)
+		           ? getIOEfromCache(pos, Egamma_)
+		           : this->integrateOverEnergy(pos, Egamma_, *kernels);
+	};
+
 	// Sum over rings
-	for (const auto &ring : *ngdensity) {
+	for (const auto &ringPtr : *ngdensity) {
 		// TODO: this could be better
-		if (!ngdensity->isRingEnabled(ring->getIndex())) continue;
+		if (!ngdensity->isRingEnabled(ringPtr->getIndex())) continue;
+
+		// the integrands only hold references, neither the ring shared_ptr
+		// nor the optical depth table are copied per LOS step
+		const neutralgas::Ring &ring = *ringPtr;
 
 		// Normalization-part
-		auto normI_f = [ring, this](const Vector3QLength &pos) {
-			return (ring->isInside(pos)) ? this->densityProfile(pos) : 0;
+		auto normI_f = [&ring, this](const Vector3QLength &pos) {
+			return (ring.isInside(pos)) ? this->densityProfile(pos) : 0;
 		};
-		auto normIntegrand = [this, normI_f, direction_](const QLength &dist) {
+		auto normIntegrand = [this, &normI_f,
+		                      &direction_](const QLength &dist) {
 			return normI_f(
 			    getGalacticPosition(this->positionSun, dist, direction_));
 		};
@@ -171,15 +214,14 @@ QDiffIntensity PiZeroAbsorptionIntegrator::integrateOverLOS(
 		if (normIntegrals == QColumnDensity(0)) continue;
 
 		// Integral over emissivity
-		auto losI_f = [ring, this](const Vector3QLength &pos,
-		                           const QEnergy &Egamma_) {
-			return (ring->isInside(pos))
-			           ? this->densityProfile(pos) *
-			                 this->integrateOverEnergy(pos, Egamma_)
+		auto losI_f = [&ring, this, &emissivity](const Vector3QLength &pos,
+		                                         const QEnergy &Egamma_) {
+			return (ring.isInside(pos))
+			           ? this->densityProfile(pos) * emissivity(pos, Egamma_)
 			           : 0;
 		};
-		auto losIntegrand = [this, losI_f, direction_, Egamma_,
-		                     findOpticalDepth](const QLength &dist) {
+		auto losIntegrand = [this, &losI_f, &direction_, &Egamma_,
+		                     &findOpticalDepth](const QLength &dist) {
 			return losI_f(
 			           getGalacticPosition(this->positionSun, dist, direction_),
 			           Egamma_) *
@@ -192,11 +234,11 @@ QDiffIntensity PiZeroAbsorptionIntegrator::integrateOverLOS(
 
 		// Finally, normalize LOS integrals, separatelly for HI and CO
 		if (ngdensity->getGasType() == neutralgas::GasType::HI) {
-			total_diff_flux += ring->getHIColumnDensity(direction_) /
+			total_diff_flux += ring.getHIColumnDensity(direction_) /
 			                   normIntegrals * losIntegrals;
 		}
 		if (ngdensity->getGasType() == neutralgas::GasType::H2) {
-			total_diff_flux += ring->getH2ColumnDensity(direction_) /
+			total_diff_flux += ring.getH2ColumnDensity(direction_) /
 			                   normIntegrals * losIntegrals;
 		}
 	}
@@ -209,43 +251,67 @@ QPDensity PiZeroAbsorptionIntegrator::densityProfile(
 	return QPDensity(1);
 }
 
+PiZeroAbsorptionIntegrator::tEnergyKernel
+PiZeroAbsorptionIntegrator::computeEnergyKernel(
+    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+    const QEnergy &Egamma_) const {
+	// TODO: micro-optimization - E_min = E_gamma + m_pi^2c^4/(4E_gamma)
+	tEnergyKernel kernel;
+	std::transform(crDensity->beginAfterEnergy(Egamma_), crDensity->end(),
+	               std::back_inserter(kernel),
+	               [this, Egamma_](const QEnergy &E) -> QPiZeroKernel {
+		               return E * crossSec->getDiffCrossSection(E, Egamma_) *
+		                      c_light;
+	               });
+	return kernel;
+}
+
+std::shared_ptr<const PiZeroAbsorptionIntegrator::tEnergyKernels>
+PiZeroAbsorptionIntegrator::getEnergyKernels(const QEnergy &Egamma_) const {
+	return energyKernels.get(Egamma_, [this](const QEnergy &E) {
+		tEnergyKernels kernels;
+		for (const auto &crDensity : kernelAxes)
+			kernels.push_back(computeEnergyKernel(crDensity, E));
+		return kernels;
+	});
+}
+
 QPiZeroIntegral PiZeroAbsorptionIntegrator::integrateOverEnergy(
     const Vector3QLength &pos_, const QEnergy &Egamma_) const {
 	if (cacheTableInitialized) return getIOEfromCache(pos_, Egamma_);
 
-	QPiZeroIntegral total(0);
-
-	// TODO: micro-optimization - E_min = E_gamma + m_pi^2c^4/(4E_gamma)
-	std::vector<QDiffCrossSection> diffCrossSectionVector;
-	std::transform(crList[0]->beginAfterEnergy(Egamma_), crList[0]->end(),
-	               std::back_inserter(diffCrossSectionVector),
-	               [this, Egamma_](const QEnergy &E) -> QDiffCrossSection {
-		               return crossSec->getDiffCrossSection(E, Egamma_);
-	               });
-
-	for (const auto &crDensity : crList) {
-		auto pid_projectile = crDensity->getPID();
+	return integrateOverEnergy(pos_, Egamma_, *getEnergyKernels(Egamma_));
+}
 
-		std::vector<QPDensity> cosmicRayVector;
-		std::transform(crDensity->beginAfterEnergy(Egamma_), crDensity->end(),
-		               std::back_inserter(cosmicRayVector),
-		               [crDensity, pos_](const QEnergy &E) -> QPDensity {
-			               return crDensity->getDensityPerEnergy(E, pos_) * E;
-		               });
-
-		std::vector<QPiZeroIntegral> integral;
-		std::transform(cosmicRayVector.begin(), cosmicRayVector.end(),
-		               diffCrossSectionVector.begin(),
-		               std::back_inserter(integral),
-		               [](const QPDensity &a, const QDiffCrossSection &b) {
-			               return a * b * c_light;
-		               });
+QPiZeroIntegral PiZeroAbsorptionIntegrator::integrateOverEnergy(
+    const Vector3QLength &pos_, const QEnergy &Egamma_,
+    const tEnergyKernels &kernels) const {
+	QPiZeroIntegral total(0);
+	// per-thread scratch buffer, it keeps its capacity between calls
+	thread_local std::vector<QPDensityPerEnergy> spectrum;
+	for (std::size_t j = 0; j < crList.size(); ++j) {
+		const auto &crDensity = crList[j];
+		// the whole spectrum is interpolated at once, the kernel belongs to
+		// its energy axis
+		crDensity->getSpectrum(pos_, spectrum);
+		const tEnergyKernel &kernel = kernels[kernelIndex[j]];
+		std::size_t offset =
+		    crDensity->beginAfterEnergy(Egamma_) - crDensity->begin();
+
+		QPiZeroIntegral integral(0);
+		for (std::size_t i = 0; i < kernel.size(); ++i)
+			integral += spectrum[offset + i] * kernel[i];
 		// log-integration
 		auto integralOverEnergy =
-		    std::log(crDensity->getEnergyScaleFactor()) *
-		    std::accumulate(integral.begin(), integral.end(),
-		                    QPiZeroIntegral(0));
+		    std::log(crDensity->getEnergyScaleFactor()) * integral;
 
+		// the target weights are already part of the density
+		if (crDensity->isProjectileWeighted()) {
+			total += integralOverEnergy;
+			continue;
+		}
+
+		auto pid_projectile = crDensity->getPID();
 		for (const auto &neutralGas : ngdensity->getAbundanceFractions()) {
 			auto pid_target = neutralGas.first;
 			auto f_target = neutralGas.second;
@@ -260,13 +326,13 @@ QInverseLength PiZeroAbsorptionIntegrator::integrateOverPhotonEnergy(
     const Vector3QLength &pos_, const QEnergy &Egamma_) const {
 	QInverseLength K(0);
 
-	auto integrand = [this, pos_, Egamma_](
+	std::vector<QEnergyDensity> photonSpectrum;
+	phdensity->getSpectrum(pos_, photonSpectrum);
+	auto integrand = [this, &photonSpectrum, Egamma_](
 	                     const cosmicrays::CosmicRayDensity::iterator itE,
 	                     const QEnergy &deltaE) {
 		return bwCrossSec->integratedOverTheta(Egamma_, (*itE)) *
-		       phdensity->getEnergyDensity(
-		           pos_, static_cast<int>(itE - phdensity->begin())) /
-		       pow<2>(*itE);
+		       photonSpectrum[itE - phdensity->begin()] / pow<2>(*itE);
 	};
 
 	for (auto itE = std::next(phdensity->begin()); itE != phdensity->end();
@@ -22,7 +22,10 @@ PiZeroIntegrator::PiZeroIntegrator(
           crDensity_}),
       ngdensity(ngdensity_),
       crossSec(crossSec_),
-      dProfile(std::make_unique<neutralgas::Nakanishi06>()) {}
+      dProfile(std::make_unique<neutralgas::Nakanishi06>()) {
+	checkProjectileWeights();
+	indexEnergyAxes();
+}
 
 PiZeroIntegrator::PiZeroIntegrator(
     const std::vector<std::shared_ptr<cosmicrays::CosmicRayDensity>> &crList_,
@@ -32,10 +35,34 @@ PiZeroIntegrator::PiZeroIntegrator(
       crList(crList_),
       ngdensity(ngdensity_),
       crossSec(crossSec_),
-      dProfile(std::make_shared<neutralgas::Nakanishi06>()) {}
+      dProfile(std::make_shared<neutralgas::Nakanishi06>()) {
+	checkProjectileWeights();
+	indexEnergyAxes();
+}
 
 PiZeroIntegrator::~PiZeroIntegrator() {}
 
+void PiZeroIntegrator::indexEnergyAxes() {
+	kernelIndex.clear();
+	kernelAxes.clear();
+	for (const auto &crDensity : crList) {
+		std::size_t k = 0;
+		while (k < kernelAxes.size() &&
+		       !crDensity->hasSameEnergyAxis(*kernelAxes[k]))
+			++k;
+		if (k == kernelAxes.size()) kernelAxes.push_back(crDensity);
+		kernelIndex.push_back(k);
+	}
+}
+
+void PiZeroIntegrator::checkProjectileWeights() const {
+	for (const auto &crDensity : crList)
+		if (crDensity->isProjectileWeighted())
+			crossSec->checkProjectileWeights(
+			    crDensity->getProjectileWeights(),
+			    ngdensity->getAbundanceFractions());
+}
+
 void PiZeroIntegrator::setupCacheTable(int N_x, int N_y, int N_z) {
 	const QLength rBorder = 35_kpc;
 	const QLength zBorder = 5_kpc;
@@ -51,12 +78,13 @@ void PiZeroIntegrator::setupCacheTable(int N_x, int N_y, int N_z) {
 void PiZeroIntegrator::computeCacheInThread(std::size_t start, std::size_t end,
                                             const QEnergy &Egamma,
                                             std::shared_ptr<ProgressBar> &p) {
+	auto kernels = getEnergyKernels(Egamma);
 	for (std::size_t i = start; i < end; ++i) {
 		auto pos =
 		    static_cast<Vector3QLength>(cacheTable->positionFromIndex(i));
 		// TODO: remove std::cerr << "pos = " << pos.x / 1_kpc << ", " << pos.y
 		// / 1_kpc << ", " << pos.z / 1_kpc << std::endl;
-		cacheTable->get(i) = this->integrateOverEnergy(pos, Egamma);
+		cacheTable->get(i) = this->integrateOverEnergy(pos, Egamma, *kernels);
 		p->update();
 	}
 }
@@ -114,26 +142,41 @@ QDiffIntensity PiZeroIntegrator::integrateOverLOS(
 
 	auto gasType = ngdensity->getGasType();
 
+	// without the cache table the kernels are resolved once for all rings
+	std::shared_ptr<const tEnergyKernels> kernels;
+	if (!cacheTableInitialized) kernels = getEnergyKernels(Egamma_);
+	auto emissivity = [this, &kernels](const Vector3QLength &pos,
+	                                   const QEnergy &Egamma_) {
+		return (cacheTableInitialized)
+		           ? getIOEfromCache(pos, Egamma_)
+		           : this->integrateOverEnergy(pos, Egamma_, *kernels);
+	};
+
 	// Sum over rings
-	for (const auto &ring : *ngdensity) {
+	for (const auto &ringPtr : *ngdensity) {
 		// TODO(adundovi): this could be checked better
-		if (!ngdensity->isRingEnabled(ring->getIndex())) continue;
+		if (!ngdensity->isRingEnabled(ringPtr->getIndex())) continue;
+
+		// the integrands are called per LOS step and copied into
+		// std::function, they only hold references so that no shared_ptr
+		// reference counts are touched on the hot path
+		const neutralgas::Ring &ring = *ringPtr;
 
 		/** Normalization-part **/
 		// p_Theta_f(r) = profile(r) * Theta_in(r)
-		auto p_Theta_f = [ring, gasType, this](const Vector3QLength &pos) {
-			return (ring->isInside(pos)) ? dProfile->getPDensity(gasType, pos)
-			                             : 0;
+		auto p_Theta_f = [&ring, gasType, this](const Vector3QLength &pos) {
+			return (ring.isInside(pos)) ? dProfile->getPDensity(gasType, pos)
+			                            : 0;
 		};
-		auto normIntegrand = [this, p_Theta_f,
-		                      direction_](const QLength &dist) {
+		auto normIntegrand = [this, &p_Theta_f,
+		                      &direction_](const QLength &dist) {
 			return p_Theta_f(
 			    getGalacticPosition(this->positionSun, dist, direction_));
 		};
 
 		// optimize LOS integration limits:
 		// instead of 0 and getMaxDistance(dir)
-		auto b = ring->getBoundaries();
+		auto b = ring.getBoundaries();
 		auto rho = positionSun.getRho();
 		QLength r_min = rho - b.second;
 		if (r_min < 0_m) r_min = 0_m;
@@ -152,15 +195,14 @@ QDiffIntensity PiZeroIntegrator::integrateOverLOS(
 
 		/** LOS integral over emissivity **/
 		// los_f = emissivity(r) * profile(r) * Theta_in(r)
-		auto los_f = [ring, gasType, this](const Vector3QLength &pos,
-		                                   const QEnergy &Egamma_) {
-			return (ring->isInside(pos))
-			           ? dProfile->getPDensity(gasType, pos) *
-			                 this->integrateOverEnergy(pos, Egamma_)
-			           : 0;
+		auto los_f = [&ring, gasType, this, &emissivity](
+		                 const Vector3QLength &pos, const QEnergy &Egamma_) {
+			return (ring.isInside(pos)) ? dProfile->getPDensity(gasType, pos) *
+			                                  emissivity(pos, Egamma_)
+			                            : 0;
 		};
-		auto losIntegrand = [this, los_f, direction_,
-		                     Egamma_](const QLength &dist) {
+		auto losIntegrand = [this, &los_f, &direction_,
+		                     &Egamma_](const QLength &dist) {
 			return los_f(
 			    getGalacticPosition(this->positionSun, dist, direction_),
 			    Egamma_);
@@ -172,56 +214,82 @@ QDiffIntensity PiZeroIntegrator::integrateOverLOS(
 
 		// Finally, normalize LOS integrals, separatelly for HI and CO
 		total_diff_flux +=
-		    ring->getColumnDensity(direction_) / normIntegral * losIntegral;
+		    ring.getColumnDensity(direction_) / normIntegral * losIntegral;
 	}
 
 	return total_diff_flux;
 }
 
+PiZeroIntegrator::tEnergyKernel PiZeroIntegrator::computeEnergyKernel(
+    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+    const QEnergy &Egamma_) const {
+	// TODO(adundovi): micro-optimization - E_min = E_gamma +
+	// m_pi^2c^4/(4E_gamma)
+	tEnergyKernel kernel;
+	std::transform(crDensity->beginAfterEnergy(Egamma_), crDensity->end(),
+	               std::back_inserter(kernel),
+	               [this, Egamma_](const QEnergy &E) -> QPiZeroKernel {
+		               return E * crossSec->getDiffCrossSection(E, Egamma_) *
+		                      c_light;
+	               });
+	return kernel;
+}
+
+QPiZeroIntegral PiZeroIntegrator::integrateSpectrum(
+    const std::shared_ptr<cosmicrays::CosmicRayDensity> &crDensity,
+    const Vector3QLength &pos_, const QEnergy &Egamma_,
+    const tEnergyKernel &kernel) const {
+	// the whole spectrum is interpolated at once into a per-thread scratch
+	// buffer which keeps its capacity, so no allocation happens per LOS step
+	thread_local std::vector<QPDensityPerEnergy> spectrum;
+	crDensity->getSpectrum(pos_, spectrum);
+	std::size_t offset =
+	    crDensity->beginAfterEnergy(Egamma_) - crDensity->begin();
+
+	// the kernel belongs to the energy axis of crDensity
+	QPiZeroIntegral integral(0);
+	for (std::size_t i = 0; i < kernel.size(); ++i)
+		integral += spectrum[offset + i] * kernel[i];
+
+	// log-integration
+	return std::log(crDensity->getEnergyScaleFactor()) * integral;
+}
+
+std::shared_ptr<const PiZeroIntegrator::tEnergyKernels>
+PiZeroIntegrator::getEnergyKernels(const QEnergy &Egamma_) const {
+	return energyKernels.get(Egamma_, [this](const QEnergy &E) {
+		tEnergyKernels kernels;
+		for (const auto &crDensity : kernelAxes)
+			kernels.push_back(computeEnergyKernel(crDensity, E));
+		return kernels;
+	});
+}
+
 QPiZeroIntegral PiZeroIntegrator::integrateOverEnergy(
     const Vector3QLength &pos_, const QEnergy &Egamma_) const {
 	if (cacheTableInitialized) {
 		return getIOEfromCache(pos_, Egamma_);
 	}
 
-	QPiZeroIntegral total(0);
+	return integrateOverEnergy(pos_, Egamma_, *getEnergyKernels(Egamma_));
+}
 
-	// TODO(adundovi): micro-optimization - E_min = E_gamma +
-	// m_pi^2c^4/(4E_gamma)
-	std::vector<QDiffCrossSection> diffCrossSectionVector;
-	std::transform(crList[0]->beginAfterEnergy(Egamma_), crList[0]->end(),
-	               std::back_inserter(diffCrossSectionVector),
-	               [this, Egamma_](const QEnergy &E) -> QDiffCrossSection {
-		               return crossSec->getDiffCrossSection(E, Egamma_);
-	               });
+QPiZeroIntegral PiZeroIntegrator::integrateOverEnergy(
+    const Vector3QLength &pos_, const QEnergy &Egamma_,
+    const tEnergyKernels &kernels) const {
+	QPiZeroIntegral total(0);
+	for (std::size_t j = 0; j < crList.size(); ++j) {
+		const auto &crDensity = crList[j];
+		auto integralOverEnergy = integrateSpectrum(crDensity, pos_, Egamma_,
+		                                            kernels[kernelIndex[j]]);
+
+		// the target weights are already part of the density
+		if (crDensity->isProjectileWeighted()) {
+			total += integralOverEnergy;
+			continue;
+		}
 
-	for (const auto &crDensity : crList) {
 		auto pid_projectile = crDensity->getPID();
-
-		std::vector<QPDensity> cosmicRayVector;
-		std::transform(crDensity->beginAfterEnergy(Egamma_), crDensity->end(),
-		               std::back_inserter(cosmicRayVector),
-		               [crDensity, pos_](const QEnergy &E) -> QPDensity {
-			               return crDensity->getDensityPerEnergy(E, pos_) * E;
-		               });
-
-		std::vector<QPiZeroIntegral> integral;
-		std::transform(cosmicRayVector.begin(), cosmicRayVector.end(),
-		               diffCrossSectionVector.begin(),
-		               std::back_inserter(integral),
-		               [](const QPDensity &a, const QDiffCrossSection &b) {
-			               return a * b * c_light;
-		               });
-		// log-integration
-		auto integralOverEnergy =
-		    std::log(crDensity->getEnergyScaleFactor()) *
-		    std::accumulate(integral.begin(), integral.end(),
-		                    QPiZeroIntegral(0));
-
-		// std::cerr << "IOE = " <<
-		// crossSec->getDiffCrossSection(*crDensity->beginAfterEnergy(Egamma_),
-		// Egamma_) << std::endl;
-
 		for (const auto &neutralGas : ngdensity->getAbundanceFractions()) {
 			auto pid_target = neutralGas.first;
 			auto f_target = neutralGas.second;
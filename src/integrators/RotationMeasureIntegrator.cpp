@@ -25,19 +25,19 @@ QRotationMeasure RotationMeasureIntegrator::integrateOverLOS(
 	    getMaxDistance(direction), 500);
 }
 
+QMField RotationMeasureIntegrator::getParallelField(
+    const Vector3QMField& B, const Vector3QLength& pos) const {
+	// TODO(adundovi): optimise
+	return B.getR() * cos((B.getValue()).getAngleTo(pos.getValue()));
+}
+
 QRMIntegral RotationMeasureIntegrator::integralFunction(
     const Vector3QLength& pos) const {
-	const auto const_a0 =
-	    pow<3>(e_plus) /
-	    (8 * pi * pi * epsilon0 * squared(m_electron) * pow<3>(c_light));
-
 	Vector3QMField B = mfield->getField(pos);
 	if (B.getR() == 0_muG) return 0;
-	// TODO(adundovi): optimise
-	QMField B_parallel =
-	    B.getR() * cos((B.getValue()).getAngleTo(pos.getValue()));
 
-	return const_a0 * B_parallel * gdensity->getDensity(pos) * radian;
+	return const_rm * getParallelField(B, pos) * gdensity->getDensity(pos) *
+	       radian;
 }
 
 }  // namespace hermes
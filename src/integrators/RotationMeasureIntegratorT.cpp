@@ -0,0 +1,10 @@
+#include "hermes/integrators/RotationMeasureIntegratorT.h"
+
+namespace hermes {
+
+// compiled into the library, next to JF12 and YMW16, so that link-time
+// optimisation can inline the models into the kernel
+template class RotationMeasureIntegratorT<magneticfields::JF12,
+                                          chargedgas::YMW16>;
+
+}  // namespace hermes
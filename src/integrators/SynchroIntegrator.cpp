@@ -2,11 +2,18 @@
 
 #include <gsl/gsl_sf_synchrotron.h>
 
+#include <cmath>
 #include <memory>
+#include <vector>
 
 #include "hermes/Common.h"
 #include "hermes/integrators/LOSIntegrationMethods.h"
 
+// range and resolution of the B_perp table used for separable CR models
+#define B_TABLE_MIN (1e-3_muG)
+#define B_TABLE_DECADES 6
+#define B_TABLE_STEPS_PER_DECADE 64
+
 namespace hermes {
 
 SynchroIntegrator::SynchroIntegrator(
@@ -14,7 +21,8 @@ SynchroIntegrator::SynchroIntegrator(
     const std::shared_ptr<cosmicrays::CosmicRayDensity> &crdensity_)
     : RadioIntegratorTemplate("Synchro"),
       mfield(mfield_),
-      crdensity(crdensity_) {}
+      crdensity(crdensity_),
+      useSeparableTable(true) {}
 
 SynchroIntegrator::~SynchroIntegrator() {}
 
@@ -24,6 +32,14 @@ void SynchroIntegrator::setFrequency(const QFrequency &freq) {
 
 QFrequency SynchroIntegrator::getFrequency() const { return skymapParameter; }
 
+void SynchroIntegrator::setUseSeparableTable(bool use) {
+	useSeparableTable = use;
+}
+
+bool SynchroIntegrator::isUsingSeparableTable() const {
+	return useSeparableTable;
+}
+
 QTemperature SynchroIntegrator::integrateOverLOS(
     const QDirection &direction) const {
 	return integrateOverLOS(direction, skymapParameter);
@@ -31,9 +47,11 @@ QTemperature SynchroIntegrator::integrateOverLOS(
 
 QTemperature SynchroIntegrator::integrateOverLOS(
     const QDirection &direction, const QFrequency &freq_) const {
-	auto integrand = [this, direction, freq_](const QLength &dist) {
+	auto table = getSeparableTable(freq_);
+	auto integrand = [this, direction, freq_, &table](const QLength &dist) {
 		return this->integrateOverEnergy(
-		    getGalacticPosition(this->positionSun, dist, direction), freq_);
+		    getGalacticPosition(this->positionSun, dist, direction), freq_,
+		    table.get());
 	};
 
 	QIntensity total_intensity = simpsonIntegration<QIntensity, QEmissivity>(
@@ -60,54 +78,128 @@ QEnergy SynchroIntegrator::singleElectronEmission(
 	return const_synchro * B_perp_ * gsl_sf_synchrotron_1(ratio);
 }
 
+QEmissivity SynchroIntegrator::integrateOverSpectralShape(
+    const QMField &B_perp_, const QFrequency &freq_) const {
+	QEmissivity emissivity(0);
+
+	if (crdensity->existsScaleFactor()) {
+		for (auto itE = crdensity->begin(); itE != crdensity->end(); ++itE)
+			emissivity += singleElectronEmission(freq_, (*itE), B_perp_) *
+			              crdensity->getSpectralShape(*itE) * (*itE);
+		return emissivity * log(crdensity->getEnergyScaleFactor());
+	}
+
+	for (auto itE = std::next(crdensity->begin()); itE != crdensity->end();
+	     ++itE) {
+		QEnergy deltaE = (*itE) - *std::prev(itE);
+		emissivity += singleElectronEmission(freq_, (*itE), B_perp_) *
+		              crdensity->getSpectralShape(*itE) * deltaE;
+	}
+	return emissivity;
+}
+
+SynchroIntegrator::tSeparableTable SynchroIntegrator::computeSeparableTable(
+    const QFrequency &freq_) const {
+	tSeparableTable table(B_TABLE_DECADES * B_TABLE_STEPS_PER_DECADE + 1);
+	for (std::size_t i = 0; i < table.size(); ++i) {
+		QMField B_perp =
+		    B_TABLE_MIN *
+		    std::pow(10., static_cast<double>(i) / B_TABLE_STEPS_PER_DECADE);
+		table[i] = integrateOverSpectralShape(B_perp, freq_);
+	}
+	return table;
+}
+
+std::shared_ptr<const SynchroIntegrator::tSeparableTable>
+SynchroIntegrator::getSeparableTable(const QFrequency &freq_) const {
+	if (!useSeparableTable || !crdensity->isSeparable()) return nullptr;
+	return separableTable.get(freq_, [this](const QFrequency &f) {
+		return computeSeparableTable(f);
+	});
+}
+
+QEmissivity SynchroIntegrator::interpolateSeparableTable(
+    const tSeparableTable &table, const QMField &B_perp_,
+    const QFrequency &freq_) const {
+	double x = std::log10(static_cast<double>(B_perp_ / B_TABLE_MIN)) *
+	           B_TABLE_STEPS_PER_DECADE;
+	if (x < 0 || x >= table.size() - 1)
+		return integrateOverSpectralShape(B_perp_, freq_);
+	// log-log interpolation, exact for power-law spectra
+	std::size_t i = static_cast<std::size_t>(x);
+	double f = x - i;
+	QEmissivity a = table[i], b = table[i + 1];
+	if (a > QEmissivity(0) && b > QEmissivity(0))
+		return a * std::pow(static_cast<double>(b / a), f);
+	return a * (1 - f) + b * f;
+}
+
+QMField SynchroIntegrator::getPerpendicularField(
+    const Vector3QMField &B, const Vector3QLength &pos_) const {
+	// skip B null-vector as it will produce NaN in the next step
+	if (B.getR() == 0_muG) return QMField(0);
+	if (pos_ == Vector3QLength(0)) return QMField(0);  // skip the origin
+	return B.getR() * sin((B.getValue()).getAngleTo(pos_.getValue()));
+}
+
 QEmissivity SynchroIntegrator::integrateOverEnergy(
     const Vector3QLength &pos_, const QFrequency &freq_) const {
+	return integrateOverEnergy(pos_, freq_, getSeparableTable(freq_).get());
+}
+
+QEmissivity SynchroIntegrator::integrateOverEnergy(
+    const Vector3QLength &pos_, const QFrequency &freq_,
+    const tSeparableTable *table) const {
+	// separable models: the energy integral depends on the position only
+	// through B_perp and is interpolated from a table built once per
+	// frequency
+	if (table != nullptr) {
+		QNumber profile = crdensity->getSpatialProfile(pos_);
+		if (profile == QNumber(0)) return QEmissivity(0);
+
+		QMField B_perp = getPerpendicularField(mfield->getField(pos_), pos_);
+		if (B_perp == 0_T) return QEmissivity(0);
+		return profile * interpolateSeparableTable(*table, B_perp, freq_);
+	}
+
+	QMField B_perp = getPerpendicularField(mfield->getField(pos_), pos_);
+	if (B_perp == 0_T) return QEmissivity(0);
+
+	std::vector<QPDensityPerEnergy> spectrum;
+	crdensity->getSpectrum(pos_, spectrum);
 	if (crdensity->existsScaleFactor()) {
-		return integrateOverLogEnergy(pos_, freq_);
+		return integrateOverLogEnergy(spectrum, B_perp, freq_);
 	} else {
-		return integrateOverSumEnergy(pos_, freq_);
+		return integrateOverSumEnergy(spectrum, B_perp, freq_);
 	}
 }
 
 QEmissivity SynchroIntegrator::integrateOverSumEnergy(
-    const Vector3QLength &pos_, const QFrequency &freq_) const {
+    const std::vector<QPDensityPerEnergy> &spectrum,
+    const QMField &B_perp, const QFrequency &freq_) const {
 	QEmissivity emissivity(0);
 	QEnergy deltaE;
-	Vector3QMField B;
-	QMField B_perp;
-
-	B = mfield->getField(pos_);
-	// skip B null-vector as it will produce NaN in the next step
-	if (B.getR() == 0_muG) return emissivity;
-	if (pos_ == Vector3QLength(0)) return emissivity;  // skip the origin
-	B_perp = B.getR() * sin((B.getValue()).getAngleTo(pos_.getValue()));
-	if (B_perp == 0_T) return emissivity;
 
+	auto itN = std::next(spectrum.begin());
 	for (auto itE = std::next(crdensity->begin()); itE != crdensity->end();
-	     ++itE) {
+	     ++itE, ++itN) {
 		deltaE = (*itE) - *std::prev(itE);
-		emissivity += singleElectronEmission(freq_, (*itE), B_perp) *
-		              crdensity->getDensityPerEnergy(*itE, pos_) * deltaE;
+		emissivity +=
+		    singleElectronEmission(freq_, (*itE), B_perp) * (*itN) * deltaE;
 	}
 
 	return emissivity;
 }
 
 QEmissivity SynchroIntegrator::integrateOverLogEnergy(
-    const Vector3QLength &pos_, const QFrequency &freq_) const {
+    const std::vector<QPDensityPerEnergy> &spectrum,
+    const QMField &B_perp, const QFrequency &freq_) const {
 	QEmissivity emissivity(0);
-	Vector3QMField B;
-	QMField B_perp;
-
-	B = mfield->getField(pos_);
-	if (B.getR() == 0_muG) return emissivity;
-	if (pos_ == Vector3QLength(0)) return emissivity;  // skip the origin
-	B_perp = B.getR() * sin((B.getValue()).getAngleTo(pos_.getValue()));
-	if (B_perp == 0_T) return emissivity;
-
-	for (auto itE = crdensity->begin(); itE != crdensity->end(); ++itE) {
-		emissivity += singleElectronEmission(freq_, (*itE), B_perp) *
-		              crdensity->getDensityPerEnergy(*itE, pos_) * (*itE);
+
+	auto itN = spectrum.begin();
+	for (auto itE = crdensity->begin(); itE != crdensity->end(); ++itE, ++itN) {
+		emissivity +=
+		    singleElectronEmission(freq_, (*itE), B_perp) * (*itN) * (*itE);
 	}
 
 	return emissivity * log(crdensity->getEnergyScaleFactor());
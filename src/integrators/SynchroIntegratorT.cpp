@@ -0,0 +1,11 @@
+#include "hermes/integrators/SynchroIntegratorT.h"
+
+namespace hermes {
+
+#ifdef HERMES_HAVE_CFITSIO
+// compiled into the library, next to JF12 and Dragon2D, so that link-time
+// optimisation can inline the models into the kernel
+template class SynchroIntegratorT<magneticfields::JF12, cosmicrays::Dragon2D>;
+#endif  // HERMES_HAVE_CFITSIO
+
+}  // namespace hermes
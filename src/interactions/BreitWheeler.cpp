@@ -2,7 +2,9 @@
 
 #include <gsl/gsl_integration.h>
 
+#include <cmath>
 #include <functional>
+#include <vector>
 
 #include "hermes/Common.h"
 
@@ -10,54 +12,108 @@
 #define GSL_EPSINT 1e-2
 #define GSL_KEYINT 3
 
-namespace hermes { namespace interactions {
-
-BreitWheeler::BreitWheeler() {}
+// nodes of the table at chi - 1/2 = 10^(k / TABLE_PER_DECADE) * TABLE_MIN
+#define TABLE_MIN 1e-6
+#define TABLE_DECADES 18
+#define TABLE_PER_DECADE 100
+// relative accuracy of the integration of the nodes
+#define TABLE_EPSINT 1e-9
 
-QArea BreitWheeler::getCrossSection(const QEnergy &Egamma, const QEnergy &Eph,
-                                    const QAngle &theta) const {
-	QNumber costheta = cos(theta);
-	QNumber chi = Egamma * Eph / (2 * pow<2>(m_electron * c_squared));
-	QNumber x = chi * (1_num - costheta);
+namespace hermes { namespace interactions {
 
-	if (x < 1_num) return QArea(0);
+/** Cross-section in units of sigma_Thompson at x = chi (1 - cos(theta)) */
+static double crossSection(double x) {
+	if (x < 1) return 0;
 
-	QNumber beta = sqrt(1_num - 1 / x);
+	// 1 - beta^2 = 1 / x, and (1 + beta) / (1 - beta) = (1 + beta)^2 x
+	// avoids the cancellation in 1 - beta at large x
+	double beta = std::sqrt(1 - 1 / x);
 
-	return 3. / 16. * sigma_Thompson * (1_num - beta * beta) *
-	       (2 * beta * (beta * beta - 2_num) +
-	        (3_num - pow<4>(beta)) * log((1_num + beta) / (1_num - beta)));
+	return 3. / 16. / x *
+	       (2 * beta * (beta * beta - 2) +
+	        (3 - std::pow(beta, 4)) * std::log((1 + beta) * (1 + beta) * x));
 }
 
-QArea BreitWheeler::integratedOverTheta(const QEnergy &Egamma,
-                                        const QEnergy &Eph) const {
-	QNumber chi = Egamma * Eph / (2 * pow<2>(m_electron * c_squared));
+/** Integral of (1 - cos(theta)) sigma over theta in units of
+ * sigma_Thompson. With y = 1 - cos(theta) = exp(u) it is
+ * 2 int y^(3/2) sigma(chi y) / sqrt(2 - y) du from u = -ln(chi) to ln(2);
+ * u = -ln(chi) + ln(2 chi) sin^2(phi / 2) removes the square-root
+ * behaviour at both ends, the integrand is smooth in phi from 0 to pi */
+static double integrateOverTheta(double chi, double rel_error) {
+	if (chi <= 0.5) return 0;
 
-	if (chi < 0.5_num) return QArea(0);
-
-	QAngle a = acos(1_num - 1 / chi);
-	QAngle b = pi * 2.0_rad - a;
+	const double L = std::log(2 * chi);
 	double abs_error = 0.0;  // disabled
-	double rel_error = 1.0e-2;
 	int key = GSL_INTEG_GAUSS51;  // GSL_INTEG_GAUSS15;
 	double result = 0;
 	double error = 0;
-	int N = 3000;
 
-	auto integrand = [this, Egamma, Eph](double th) {
-		return (1 - std::cos(th)) *
-		       static_cast<double>(getCrossSection(Egamma, Eph, QAngle(th)));
+	auto integrand = [chi, L](double phi) {
+		double s = std::sin(phi / 2), c = std::cos(phi / 2);
+		double x = std::exp(L * s * s);  // chi y
+		double y = x / chi;
+		double twoMinusY = -2 * std::expm1(-L * c * c);
+		double dudphi = L * s * c;
+		return 2 * y * std::sqrt(y / twoMinusY) * crossSection(x) * dudphi;
 	};
 
 	gsl_function_pp<decltype(integrand)> Fp(integrand);
 	gsl_function *F = static_cast<gsl_function *>(&Fp);
 
 	gsl_integration_workspace *w = gsl_integration_workspace_alloc(GSL_LIMIT);
-	gsl_integration_qag(F, static_cast<double>(a), static_cast<double>(b),
-	                    abs_error, rel_error, N, key, w, &result, &error);
+	gsl_integration_qag(F, 0, M_PI, abs_error, rel_error, GSL_LIMIT, key, w,
+	                    &result, &error);
 	gsl_integration_workspace_free(w);
 
 	return result;
 }
 
+/** ln(integrateOverTheta()) at the nodes of the table; a function-local
+ * static, so it is built once and thread-safe */
+static const std::vector<double> &opacityTable() {
+	static const std::vector<double> table = []() {
+		std::vector<double> t(TABLE_DECADES * TABLE_PER_DECADE + 1);
+		for (std::size_t k = 0; k < t.size(); ++k) {
+			double chi =
+			    0.5 + TABLE_MIN * std::pow(10., static_cast<double>(k) /
+			                                        TABLE_PER_DECADE);
+			t[k] = std::log(integrateOverTheta(chi, TABLE_EPSINT));
+		}
+		return t;
+	}();
+	return table;
+}
+
+BreitWheeler::BreitWheeler() : useTable(true) { opacityTable(); }
+
+QArea BreitWheeler::getCrossSection(const QEnergy &Egamma, const QEnergy &Eph,
+                                    const QAngle &theta) const {
+	QNumber costheta = cos(theta);
+	QNumber chi = Egamma * Eph / (2 * pow<2>(m_electron * c_squared));
+	QNumber x = chi * (1_num - costheta);
+
+	return sigma_Thompson * crossSection(static_cast<double>(x));
+}
+
+QArea BreitWheeler::integratedOverTheta(const QEnergy &Egamma,
+                                        const QEnergy &Eph) const {
+	double chi = static_cast<double>(Egamma * Eph /
+	                                 (2 * pow<2>(m_electron * c_squared)));
+
+	if (chi < 0.5) return QArea(0);
+
+	if (useTable) {
+		const std::vector<double> &table = opacityTable();
+		double t = std::log10((chi - 0.5) / TABLE_MIN) * TABLE_PER_DECADE;
+		if (t >= 0 && t < table.size() - 1) {
+			std::size_t k = static_cast<std::size_t>(t);
+			double f = t - k;
+			return sigma_Thompson *
+			       std::exp(table[k] * (1 - f) + table[k + 1] * f);
+		}
+	}
+
+	return sigma_Thompson * integrateOverTheta(chi, GSL_EPSINT);
+}
+
 }}  // namespace hermes::interactions
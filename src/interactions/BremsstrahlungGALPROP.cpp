@@ -1,9 +1,15 @@
 #include "hermes/interactions/BremsstrahlungGALPROP.h"
 
+#include <gsl/gsl_errno.h>
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_math.h>
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
 
 #include "hermes/Common.h"
 
@@ -15,14 +21,41 @@
 #define EPSINT 1e-5
 #define KEYINT 15
 
+// nodes of the table: TABLE_PER_DECADE per decade in T_electron from
+// TABLE_T_MIN to TABLE_T_MAX and in E_gamma / (T_electron - E_gamma) from
+// 10^TABLE_S_MIN to 10^TABLE_S_MAX
+#define TABLE_PER_DECADE 32
+#define TABLE_T_MIN (0.01_MeV)
+#define TABLE_T_MAX (1_PeV)
+#define TABLE_S_MIN (-9)
+#define TABLE_S_MAX 4
+
 namespace hermes { namespace interactions {
 
+namespace {
+
+// one integration workspace per thread, reused by all integrals
+gsl_integration_workspace *getWorkspace() {
+	thread_local std::unique_ptr<gsl_integration_workspace,
+	                             void (*)(gsl_integration_workspace *)>
+	    w(gsl_integration_workspace_alloc(LIMIT),
+	      gsl_integration_workspace_free);
+	return w.get();
+}
+
+// set when an integral of this thread did not converge, only read while the
+// table is built (with the GSL error handler switched off)
+thread_local bool integrationFailed = false;
+
+}  // namespace
+
 BremsstrahlungGALPROP::BremsstrahlungGALPROP()
     : BremsstrahlungAbstract(),
       cachingEnabled(true),
       cache({std::make_unique<CacheStorageCrossSection>(),
              std::make_unique<CacheStorageCrossSection>(),
-             std::make_unique<CacheStorageCrossSection>()}) {
+             std::make_unique<CacheStorageCrossSection>()}),
+      tableEnabled(true) {
 	// Initialize caching for all targets
 	for (auto &t : allTargets) {
 		cache[static_cast<int>(t)]->setFunction(
@@ -31,14 +64,126 @@ BremsstrahlungGALPROP::BremsstrahlungGALPROP()
 			                                                      E_gamma);
 		    });
 	}
+	table = buildTable();
 }
 
 void BremsstrahlungGALPROP::enableCaching() { cachingEnabled = true; };
 
 void BremsstrahlungGALPROP::disableCaching() { cachingEnabled = false; };
 
+void BremsstrahlungGALPROP::enableTable() {
+	if (!table) table = buildTable();
+	tableEnabled = true;
+}
+
+void BremsstrahlungGALPROP::disableTable() { tableEnabled = false; }
+
+bool BremsstrahlungGALPROP::isTableEnabled() const { return tableEnabled; }
+
+std::unique_ptr<BremsstrahlungGALPROP::tTable>
+BremsstrahlungGALPROP::buildTable() const {
+	auto table_ = std::make_unique<tTable>();
+	// segments of the T_electron axis between the energy regimes of
+	// getDiffCrossSectionForTargetDirectly(); the end points of a segment
+	// are evaluated just inside of it
+	const std::array<QEnergy, 4> bounds = {TABLE_T_MIN, 0.07_MeV, 2_MeV,
+	                                       TABLE_T_MAX};
+	std::vector<double> T;
+	for (std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+		double lnLo = std::log(static_cast<double>(bounds[b]));
+		double lnHi = std::log(static_cast<double>(bounds[b + 1]));
+		std::size_t n = static_cast<std::size_t>(
+		    std::ceil((lnHi - lnLo) / std::log(10.) * TABLE_PER_DECADE));
+		for (std::size_t i = 0; i <= n; ++i) {
+			double lnT = (i == n) ? lnHi : lnLo + (lnHi - lnLo) * i / n;
+			double shift = (i == 0) ? 1e-9 : ((i == n) ? -1e-9 : 0);
+			table_->lnT.push_back(lnT);
+			T.push_back(std::exp(lnT) * (1 + shift));
+		}
+	}
+
+	table_->sMin = TABLE_S_MIN * std::log(10.);
+	table_->sStep = std::log(10.) / TABLE_PER_DECADE;
+	table_->nS = (TABLE_S_MAX - TABLE_S_MIN) * TABLE_PER_DECADE + 1;
+
+	const std::size_t nT = T.size();
+	for (auto &values : table_->values) values.assign(nT * table_->nS, 0);
+
+	// a node whose integrals fail is stored as NaN, and the lookups around
+	// it fall back to the direct calculation; the handler is process-wide,
+	// so GSL errors of other threads are not reported while this runs
+	gsl_error_handler_t *handler = gsl_set_error_handler_off();
+
+	// every thread fills whole rows of one target, so no two threads write
+	// the same node
+	auto fillRows = [this, &table_, &T, nT](unsigned int start,
+	                                        unsigned int stop) {
+		for (unsigned int i = start; i < stop; ++i) {
+			Target t = allTargets[i / nT];
+			std::size_t iT = i % nT;
+			double *row = table_->values[i / nT].data() + iT * table_->nS;
+			for (std::size_t j = 0; j < table_->nS; ++j) {
+				// E_gamma / (T - E_gamma) = exp(s)
+				double s = table_->sMin + j * table_->sStep;
+				QEnergy E_gamma(T[iT] / (1 + std::exp(-s)));
+				integrationFailed = false;
+				row[j] = std::log(
+				    static_cast<double>(getDiffCrossSectionForTargetDirectly(
+				        t, QEnergy(T[iT]), E_gamma)));
+				if (integrationFailed)
+					row[j] = std::numeric_limits<double>::quiet_NaN();
+			}
+		}
+	};
+
+	auto job_chunks = getThreadChunks(Ntargets * nT);
+	std::vector<std::thread> threads;
+	for (auto &chunk : job_chunks)
+		threads.push_back(std::thread(fillRows, chunk.first, chunk.second));
+	for (auto &t : threads) t.join();
+
+	gsl_set_error_handler(handler);
+	return table_;
+}
+
+bool BremsstrahlungGALPROP::interpolateTable(Target t,
+                                             const QEnergy &T_electron,
+                                             const QEnergy &E_gamma,
+                                             QDiffCrossSection &result) const {
+	const tTable &table_ = *table;
+	double T = static_cast<double>(T_electron);
+	double E = static_cast<double>(E_gamma);
+
+	// lnT[i] <= ln(T) < lnT[i + 1], which never selects the empty cells at
+	// the regime boundaries
+	double lnT = std::log(T);
+	auto upper = std::upper_bound(table_.lnT.begin(), table_.lnT.end(), lnT);
+	if (upper == table_.lnT.begin() || upper == table_.lnT.end()) return false;
+	std::size_t i = upper - table_.lnT.begin() - 1;
+
+	double s = (std::log(E / (T - E)) - table_.sMin) / table_.sStep;
+	if (!(s >= 0 && s < table_.nS - 1)) return false;
+	std::size_t j = static_cast<std::size_t>(s);
+
+	double fT = (lnT - table_.lnT[i]) / (table_.lnT[i + 1] - table_.lnT[i]);
+	double fs = s - j;
+	const double *v =
+	    table_.values[static_cast<int>(t)].data() + i * table_.nS + j;
+	double lnSigma = (1 - fT) * ((1 - fs) * v[0] + fs * v[1]) +
+	                 fT * ((1 - fs) * v[table_.nS] + fs * v[table_.nS + 1]);
+
+	// vanishing cross-sections at a corner are left to the direct calculation
+	if (!std::isfinite(lnSigma)) return false;
+	result = QDiffCrossSection(std::exp(lnSigma));
+	return true;
+}
+
 QDiffCrossSection BremsstrahlungGALPROP::getDiffCrossSectionForTarget(
     Target t, const QEnergy &T_electron, const QEnergy &E_gamma) const {
+	if (tableEnabled && table && E_gamma < T_electron) {
+		QDiffCrossSection result;
+		if (interpolateTable(t, T_electron, E_gamma, result)) return result;
+	}
 	if (cachingEnabled)
 		return cache[static_cast<int>(t)]->getValue(T_electron, E_gamma);
 	return getDiffCrossSectionForTargetDirectly(t, T_electron, E_gamma);
@@ -93,9 +238,9 @@ QNumber BremsstrahlungGALPROP::I_Phi_1(const QNumber &delta_, int Z,
 	gsl_function_pp<decltype(R_N)> Fp(R_N);
 	gsl_function *F = static_cast<gsl_function *>(&Fp);
 
-	gsl_integration_workspace *w = gsl_integration_workspace_alloc(LIMIT);
-	gsl_integration_qags(F, delta, 1, 0, EPSINT, LIMIT, w, &result, &error);
-	gsl_integration_workspace_free(w);
+	if (gsl_integration_qags(F, delta, 1, 0, EPSINT, LIMIT, getWorkspace(),
+	                         &result, &error) != GSL_SUCCESS)
+		integrationFailed = true;
 
 	return result;
 }
@@ -114,9 +259,9 @@ QNumber BremsstrahlungGALPROP::I_Phi_2(const QNumber &delta_, int Z,
 	gsl_function_pp<decltype(R_N)> Fp(R_N);
 	gsl_function *F = static_cast<gsl_function *>(&Fp);
 
-	gsl_integration_workspace *w = gsl_integration_workspace_alloc(LIMIT);
-	gsl_integration_qags(F, delta, 1, 0, EPSINT, LIMIT, w, &result, &error);
-	gsl_integration_workspace_free(w);
+	if (gsl_integration_qags(F, delta, 1, 0, EPSINT, LIMIT, getWorkspace(),
+	                         &result, &error) != GSL_SUCCESS)
+		integrationFailed = true;
 
 	return result;
 }
@@ -4,7 +4,18 @@
 
 namespace hermes { namespace interactions {
 
-BremsstrahlungTsai74::BremsstrahlungTsai74() : BremsstrahlungAbstract() {}
+BremsstrahlungTsai74::BremsstrahlungTsai74() : BremsstrahlungAbstract() {
+	for (auto &t : allTargets) {
+		int Z = (t == Target::He) ? 2 : 1;
+		double f = computeCoulombCorrection(Z);
+		std::pair<double, double> radLogs = RadiationLogarithms(Z);
+		double F_el = radLogs.first;
+		double F_inel = radLogs.second;
+
+		screening[static_cast<int>(t)] = Z * Z * (F_el - f) + Z * F_inel;
+		X2Factor[static_cast<int>(t)] = (Z * Z + Z) / 3.;
+	}
+}
 
 std::pair<double, double> BremsstrahlungTsai74::RadiationLogarithms(
     int Z) const {
@@ -30,39 +41,25 @@ std::pair<double, double> BremsstrahlungTsai74::RadiationLogarithms(
 
 double BremsstrahlungTsai74::computeCoulombCorrection(int Z,
                                                       std::size_t n_max) const {
+	// f(Z) = a^2 sum_n 1 / (n (n^2 + a^2)) with a = alpha Z
+	const double a2 = static_cast<double>(alpha_fine * alpha_fine) * Z * Z;
 	double value = 0;
-	for (size_t n = 1; n < n_max; ++n)
-		value += 1. / n /
-		         (n * n + static_cast<double>(alpha_fine * alpha_fine) *
-		                      static_cast<double>(Z * Z));
-	return value;
+	for (size_t n = 1; n < n_max; ++n) value += 1. / n / (n * n + a2);
+	return a2 * value;
 }
 
 QDiffCrossSection BremsstrahlungTsai74::getDiffCrossSectionForTarget(
     Target t, const QEnergy &T_electron, const QEnergy &E_gamma) const {
 	if (E_gamma >= T_electron) return QDiffCrossSection(0);
 
-	int Z;
-	if (t == Target::HII || t == Target::HI) {
-		Z = 1;
-	}
-	if (t == Target::He) {
-		Z = 2;
-	}
-
 	QDiffCrossSection xsecs =
 	    4. * alpha_fine * pow<2>(r_electron) / 3. / E_gamma;
 
 	QEnergy E_electron = T_electron + m_electron * c_squared;
 	double y = static_cast<double>(E_gamma / E_electron);
-	double f = computeCoulombCorrection(Z);
-	std::pair<double, double> radLogs = RadiationLogarithms(Z);
-	double F_el = radLogs.first;
-	double F_inel = radLogs.second;
 
-	const auto X1 =
-	    (4. - 4. * y + y * y / 3.) * (Z * Z * (F_el - f) + Z * F_inel);
-	const auto X2 = (1. - y) * (Z * Z + Z) / 3.;
+	const auto X1 = (4. - 4. * y + y * y / 3.) * screening[static_cast<int>(t)];
+	const auto X2 = (1. - y) * X2Factor[static_cast<int>(t)];
 
 	return (X1 + X2) * xsecs;
 }
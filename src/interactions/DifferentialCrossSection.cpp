@@ -1,5 +1,9 @@
 #include "hermes/interactions/DiffCrossSection.h"
 
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
 namespace hermes { namespace interactions {
 
 DifferentialCrossSection::DifferentialCrossSection(bool cachingEnabled_)
@@ -31,4 +35,33 @@ QNumber DifferentialCrossSection::getSigma(const PID &projectile,
 	return 0.0_num;
 }
 
+std::map<PID, double> DifferentialCrossSection::getProjectileWeights(
+    const std::vector<PID> &projectiles,
+    const std::vector<std::pair<PID, double>> &targets) const {
+	std::map<PID, double> weights;
+	for (const auto &p : projectiles) {
+		double w = 0;
+		for (const auto &t : targets)
+			w += t.second * static_cast<double>(getSigma(p, t.first));
+		weights[p] = w;
+	}
+	return weights;
+}
+
+void DifferentialCrossSection::checkProjectileWeights(
+    const std::map<PID, double> &weights,
+    const std::vector<std::pair<PID, double>> &targets) const {
+	for (const auto &w : weights) {
+		double expected = getProjectileWeights({w.first}, targets)[w.first];
+		if (std::fabs(w.second - expected) <= 1e-6 * std::fabs(expected))
+			continue;
+		std::stringstream ss;
+		ss << "checkProjectileWeights: weight " << w.second
+		   << " of the projectile with id " << w.first.getID()
+		   << " does not match " << expected
+		   << " of this cross-section and targets";
+		throw std::runtime_error(ss.str());
+	}
+}
+
 }}  // namespace hermes::interactions
@@ -0,0 +1,231 @@
+#include "hermes/magneticfields/BakedMagneticField.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include "hermes/Common.h"
+#include "hermes/Random.h"
+#include "kiss/logger.h"
+
+namespace hermes { namespace magneticfields {
+
+BakedMagneticField::BakedMagneticField(
+    const std::shared_ptr<MagneticField> &model_, const Vector3QLength &origin,
+    size_t Nx, size_t Ny, size_t Nz, const Vector3QLength &spacing,
+    std::size_t validationPoints)
+    : model(model_), maxError(0), maxField(0), sqrtbeta(0) {
+	// a JF12 passed as MagneticField is baked like the JF12 overload does
+	auto jf12 = std::dynamic_pointer_cast<JF12>(model_);
+	if (jf12) {
+		bakeJF12(jf12, origin, Nx, Ny, Nz, spacing, validationPoints);
+		return;
+	}
+
+	initGrid(origin, Nx, Ny, Nz, spacing);
+
+	auto fields = [this](const std::vector<Vector3QLength> &positions,
+	                     std::vector<Vector3QMField> &values) {
+		model->getFields(positions, values);
+	};
+	bake(fields);
+	validate(fields, validationPoints);
+}
+
+BakedMagneticField::BakedMagneticField(const std::shared_ptr<JF12> &jf12,
+                                       const Vector3QLength &origin,
+                                       size_t Nx, size_t Ny, size_t Nz,
+                                       const Vector3QLength &spacing,
+                                       std::size_t validationPoints)
+    : BakedMagneticField(std::static_pointer_cast<MagneticField>(jf12),
+                         origin, Nx, Ny, Nz, spacing, validationPoints) {}
+
+void BakedMagneticField::bakeJF12(const std::shared_ptr<JF12> &jf12,
+                                  const Vector3QLength &origin, size_t Nx,
+                                  size_t Ny, size_t Nz,
+                                  const Vector3QLength &spacing,
+                                  std::size_t validationPoints) {
+	sqrtbeta = jf12->getStriatedStrength();
+	initGrid(origin, Nx, Ny, Nz, spacing);
+
+	// as in JF12::getField(), the striated field includes the regular one
+	bool useRegular = jf12->isUsingRegular() || jf12->isUsingStriated();
+	auto regular = [&jf12, useRegular](
+	                   const std::vector<Vector3QLength> &positions,
+	                   std::vector<Vector3QMField> &values) {
+		values.assign(positions.size(), Vector3QMField(0.));
+		if (!useRegular) return;
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			values[i] = jf12->getRegularField(
+			    JF12::toModelCoordinates(positions[i]));
+	};
+	bake(regular);
+	validate(regular, validationPoints);
+
+	if (jf12->isUsingStriated()) striatedGrid = jf12->getStriatedGrid();
+
+	if (jf12->isUsingTurbulent()) {
+		turbulentGrid = jf12->getTurbulentGrid();
+		turbulentModes = jf12->getTurbulentModes();
+		turbulentStrength = std::make_shared<BakedGrid>(
+		    origin, Nx, Ny, Nz, spacing);
+		turbulentStrength->bake(
+		    [&jf12](const std::vector<Vector3QLength> &positions,
+		            std::vector<double> &values) {
+			    values.resize(positions.size());
+			    for (std::size_t i = 0; i < positions.size(); ++i)
+				    values[i] = static_cast<double>(jf12->getTurbulentStrength(
+				        JF12::toModelCoordinates(positions[i])));
+		    });
+	}
+}
+
+void BakedMagneticField::initGrid(const Vector3QLength &origin, size_t Nx,
+                                  size_t Ny, size_t Nz,
+                                  const Vector3QLength &spacing) {
+	if (Nx < 2 || Ny < 2 || Nz < 2)
+		throw std::runtime_error(
+		    "BakedMagneticField: at least 2 grid points per axis are needed");
+
+	grid = std::make_shared<VectorQMFieldGrid>(origin.getValue(), Nx, Ny, Nz,
+	                                           spacing.getValue());
+	grid->setReflective(true);
+	lower = grid->getOrigin() + grid->getSpacing() / 2;
+	upper = grid->getOrigin() +
+	        Vector3d(Nx - 0.5, Ny - 0.5, Nz - 0.5) * grid->getSpacing();
+	invSpacing = Vector3d(1.) / grid->getSpacing();
+}
+
+void BakedMagneticField::bake(const BatchFunction &f) {
+	size_t Ny = grid->getNy();
+	size_t Nz = grid->getNz();
+	Vector3d origin = grid->getOrigin() + grid->getSpacing() / 2;
+	Vector3d spacing = grid->getSpacing();
+
+	// every thread fills whole z columns, so no two threads write the same
+	// grid point
+	auto fillColumns = [this, &f, Ny, Nz, origin, spacing](
+	                       unsigned int start, unsigned int stop) {
+		std::vector<Vector3QLength> positions(Nz);
+		std::vector<Vector3QMField> values;
+		for (unsigned int i = start; i < stop; ++i) {
+			size_t ix = i / Ny;
+			size_t iy = i % Ny;
+			for (size_t iz = 0; iz < Nz; ++iz)
+				positions[iz] = Vector3QLength(
+				    origin + Vector3d(ix, iy, iz) * spacing);
+			f(positions, values);
+			for (size_t iz = 0; iz < Nz; ++iz)
+				grid->get(ix, iy, iz) = values[iz];
+		}
+	};
+
+	auto job_chunks = getThreadChunks(grid->getNx() * Ny);
+	std::vector<std::thread> threads;
+	for (auto &chunk : job_chunks)
+		threads.push_back(std::thread(fillColumns, chunk.first, chunk.second));
+	for (auto &t : threads) t.join();
+}
+
+void BakedMagneticField::validate(const BatchFunction &f,
+                                  std::size_t validationPoints) {
+	if (validationPoints == 0) return;
+
+	Random random;
+	random.seed(42);
+	std::vector<Vector3QLength> positions(validationPoints);
+	for (auto &pos : positions)
+		pos = Vector3QLength(Vector3d(random.randUniform(lower.x, upper.x),
+		                              random.randUniform(lower.y, upper.y),
+		                              random.randUniform(lower.z, upper.z)));
+
+	std::vector<Vector3QMField> values;
+	f(positions, values);
+
+	double error = 0, maxValue = 0;
+	for (std::size_t i = 0; i < validationPoints; ++i) {
+		Vector3d b = values[i].getValue();
+		Vector3d d = interpolate(positions[i].getValue()).getValue() - b;
+		error = std::max(error, d.getR());
+		maxValue = std::max(maxValue, b.getR());
+	}
+	maxError = QMField(error);
+	maxField = QMField(maxValue);
+
+	double error_muG = static_cast<double>(maxError / 1_muG);
+	double field_muG = static_cast<double>(maxField / 1_muG);
+	KISS_LOG_INFO << "BakedMagneticField: max. interpolation error "
+	              << error_muG << " muG, max. field " << field_muG << " muG"
+	              << std::endl;
+}
+
+bool BakedMagneticField::isInside(const Vector3d &r) const {
+	return r.x >= lower.x && r.x <= upper.x && r.y >= lower.y &&
+	       r.y <= upper.y && r.z >= lower.z && r.z <= upper.z;
+}
+
+bool BakedMagneticField::isInside(const Vector3QLength &pos) const {
+	return isInside(pos.getValue());
+}
+
+Vector3QMField BakedMagneticField::interpolate(const Vector3d &pos) const {
+	// positions are inside, so the lower neighbours are clamped to the
+	// last cell instead of the reflective/periodic wrapping of Grid
+	Vector3d r = (pos - lower) * invSpacing;
+	size_t Nx = grid->getNx(), Ny = grid->getNy(), Nz = grid->getNz();
+	size_t ix = std::min<size_t>(static_cast<size_t>(r.x), Nx - 2);
+	size_t iy = std::min<size_t>(static_cast<size_t>(r.y), Ny - 2);
+	size_t iz = std::min<size_t>(static_cast<size_t>(r.z), Nz - 2);
+	double fx = r.x - ix, fy = r.y - iy, fz = r.z - iz;
+
+	// eight neighbours as (weight, offset) pairs, the sum below runs over
+	// plain arrays and is vectorised by the compiler
+	const Vector3QMField *v = &grid->get(ix, iy, iz);
+	const size_t dx = Ny * Nz, dy = Nz;
+	const double w[8] = {(1 - fx) * (1 - fy) * (1 - fz),
+	                     fx * (1 - fy) * (1 - fz),
+	                     (1 - fx) * fy * (1 - fz),
+	                     fx * fy * (1 - fz),
+	                     (1 - fx) * (1 - fy) * fz,
+	                     fx * (1 - fy) * fz,
+	                     (1 - fx) * fy * fz,
+	                     fx * fy * fz};
+	const size_t o[8] = {0, dx, dy, dx + dy, 1, dx + 1, dy + 1, dx + dy + 1};
+	double bx = 0, by = 0, bz = 0;
+	for (int k = 0; k < 8; ++k) {
+		bx += w[k] * static_cast<double>(v[o[k]].x);
+		by += w[k] * static_cast<double>(v[o[k]].y);
+		bz += w[k] * static_cast<double>(v[o[k]].z);
+	}
+	return Vector3QMField(QMField(bx), QMField(by), QMField(bz));
+}
+
+Vector3QMField BakedMagneticField::getField(const Vector3QLength &pos) const {
+	Vector3d r = pos.getValue();
+	if (!isInside(r)) return model->getField(pos);
+
+	Vector3QMField b = interpolate(r);
+	if (!striatedGrid && !turbulentStrength) return b;
+
+	// the random components live in the coordinates of JF12
+	Vector3QLength modelPos = JF12::toModelCoordinates(pos);
+	if (striatedGrid)
+		b = b * (1. + sqrtbeta * striatedGrid->closestValue(modelPos));
+	if (turbulentModes)
+		b += turbulentModes->getUnitField(modelPos) *
+		     QMField(turbulentStrength->interpolate(pos));
+	else if (turbulentGrid)
+		b += turbulentGrid->interpolate(modelPos) *
+		     QMField(turbulentStrength->interpolate(pos));
+	return b;
+}
+
+void BakedMagneticField::getFields(
+    const std::vector<Vector3QLength> &positions,
+    std::vector<Vector3QMField> &fields) const {
+	fields.resize(positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+		fields[i] = BakedMagneticField::getField(positions[i]);
+}
+
+}}  // namespace hermes::magneticfields
@@ -1,8 +1,11 @@
 #include "hermes/magneticfields/JF12.h"
 
 #include <iostream>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include "hermes/Common.h"
 #include "hermes/GridTools.h"
 #include "hermes/Random.h"
 
@@ -83,33 +86,43 @@ JF12::JF12() {
 }
 
 void JF12::randomStriated(int seed) {
-	useStriated = true;
 	int N = 100;
 	striatedGrid = std::make_shared<ScalarGrid>(
 	    ScalarGrid(Vector3d(0.), N, static_cast<double>(0.1_kpc)));
 
-	Random random;
-	if (seed != 0) random.seed(seed);
-
-	for (int ix = 0; ix < N; ix++) {
-		for (int iy = 0; iy < N; iy++) {
-			for (int iz = 0; iz < N; iz++) {
-				float &f = striatedGrid->get(ix, iy, iz);
-				f = std::round(static_cast<float>(random.rand())) * 2 - 1;
+	// a cell only depends on the seed and its index, the planes are filled
+	// in parallel with the same result for any number of threads
+	CounterRandom random((seed != 0) ? seed : Random().randInt());
+	auto fillPlanes = [this, &random, N](unsigned int start,
+	                                     unsigned int stop) {
+		for (int ix = start; ix < stop; ix++) {
+			for (int iy = 0; iy < N; iy++) {
+				for (int iz = 0; iz < N; iz++) {
+					float &f = striatedGrid->get(ix, iy, iz);
+					f = (random.rand((ix * N + iy) * N + iz) < 0.5) ? -1 : 1;
+				}
 			}
 		}
-	}
+	};
+
+	auto job_chunks = getThreadChunks(N);
+	std::vector<std::thread> threads;
+	for (auto &chunk : job_chunks)
+		threads.push_back(std::thread(fillPlanes, chunk.first, chunk.second));
+	for (auto &t : threads) t.join();
+	useStriated = true;
 }
 
 #ifdef HERMES_HAVE_FFTW3F
-void JF12::randomTurbulent(int seed) {
-	useTurbulent = true;
+void JF12::randomTurbulent(int seed, size_t N) {
 	// turbulent field with Kolmogorov spectrum, B_rms = 1 and Lc = 60
 	// parsec
 	turbulentGrid = std::make_shared<VectorGrid>(
-	    VectorGrid(Vector3d(0.), 256, static_cast<double>(4_pc)));
+	    VectorGrid(Vector3d(0.), N, static_cast<double>(4_pc)));
 	initTurbulence(turbulentGrid, 1, static_cast<double>(8_pc),
 	               static_cast<double>(272_pc), -11. / 3., seed);
+	turbulentModes.reset();
+	useTurbulent = true;
 }
 #endif
 
@@ -121,6 +134,13 @@ void JF12::setStriatedGrid(std::shared_ptr<ScalarGrid> grid) {
 void JF12::setTurbulentGrid(std::shared_ptr<VectorGrid> grid) {
 	useTurbulent = true;
 	turbulentGrid = std::move(grid);
+	turbulentModes.reset();
+}
+
+void JF12::setTurbulentModes(std::shared_ptr<PlaneWaveTurbulence> modes) {
+	useTurbulent = true;
+	turbulentModes = std::move(modes);
+	turbulentGrid.reset();
 }
 
 std::shared_ptr<ScalarGrid> JF12::getStriatedGrid() {
@@ -131,6 +151,10 @@ std::shared_ptr<VectorGrid> JF12::getTurbulentGrid() {
 	return turbulentGrid;
 }
 
+std::shared_ptr<PlaneWaveTurbulence> JF12::getTurbulentModes() {
+	return turbulentModes;
+}
+
 void JF12::setUseRegular(bool use) { useRegular = use; }
 
 void JF12::setUseStriated(bool use) {
@@ -286,16 +310,23 @@ QMField JF12::getTurbulentStrength(const Vector3QLength &pos) const {
 }
 
 Vector3QMField JF12::getTurbulentField(const Vector3QLength &pos) const {
+	if (turbulentModes)
+		return turbulentModes->getUnitField(pos) * getTurbulentStrength(pos);
 	return (turbulentGrid->interpolate(pos) * getTurbulentStrength(pos));
 }
 
-Vector3QMField JF12::getField(const Vector3QLength &pos_) const {
+Vector3QLength JF12::toModelCoordinates(const Vector3QLength &pos_) {
 	// the JF12 model uses right-handed Cartesian and
 	// cylindrical coordinate system
-	Vector3QMField b(0.);
 	Vector3QLength pos = pos_;
 	pos.setX(-pos_.getX());
 	// pos.setY(-pos_.getY());
+	return pos;
+}
+
+Vector3QMField JF12::getField(const Vector3QLength &pos_) const {
+	Vector3QMField b(0.);
+	Vector3QLength pos = toModelCoordinates(pos_);
 
 	if (useTurbulent) b += getTurbulentField(pos);
 	if (useStriated) {
@@ -306,4 +337,22 @@ Vector3QMField JF12::getField(const Vector3QLength &pos_) const {
 	return b;
 }
 
+void JF12::getFields(const std::vector<Vector3QLength> &positions,
+                     std::vector<Vector3QMField> &fields) const {
+	// one loop per component, without the component switches and virtual
+	// calls inside; the components are added in the order of getField()
+	fields.assign(positions.size(), Vector3QMField(0.));
+	if (useTurbulent) {
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			fields[i] += getTurbulentField(toModelCoordinates(positions[i]));
+	}
+	if (useStriated) {
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			fields[i] += getStriatedField(toModelCoordinates(positions[i]));
+	} else if (useRegular) {
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			fields[i] += getRegularField(toModelCoordinates(positions[i]));
+	}
+}
+
 }}  // namespace hermes::magneticfields
@@ -0,0 +1,98 @@
+#include "hermes/magneticfields/PlaneWaveTurbulence.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "hermes/Random.h"
+
+namespace hermes { namespace magneticfields {
+
+PlaneWaveTurbulence::PlaneWaveTurbulence(const QMField &Brms_,
+                                         const QLength &lMin,
+                                         const QLength &lMax, int nModes,
+                                         int seed, double alpha)
+    : Brms(Brms_) {
+	if (nModes < 1)
+		throw std::runtime_error("PlaneWaveTurbulence: nModes < 1");
+	if (!(lMin > 0_m) || lMin >= lMax)
+		throw std::runtime_error("PlaneWaveTurbulence: lMin >= lMax");
+
+	Random random;
+	if (seed != 0) random.seed(seed);
+
+	double kMin = 2 * M_PI / static_cast<double>(lMax);
+	double kMax = 2 * M_PI / static_cast<double>(lMin);
+	double dlnk = (nModes > 1) ? std::log(kMax / kMin) / (nModes - 1) : 1;
+
+	// squared amplitudes <B^2(k)> k^2 dk, with dk = k dln(k)
+	std::vector<double> A2(nModes);
+	double sumA2 = 0;
+	for (int n = 0; n < nModes; ++n) {
+		double k = kMin * std::exp(n * dlnk);
+		A2[n] = std::pow(k, alpha + 3);
+		sumA2 += A2[n];
+	}
+
+	kx.resize(nModes);
+	ky.resize(nModes);
+	kz.resize(nModes);
+	ax.resize(nModes);
+	ay.resize(nModes);
+	az.resize(nModes);
+	phase.resize(nModes);
+	for (int n = 0; n < nModes; ++n) {
+		double k = kMin * std::exp(n * dlnk);
+		Vector3d kappa = random.randVector();
+
+		// random polarisation perpendicular to kappa
+		Vector3d e1 = kappa.cross(std::fabs(kappa.x) < 0.9 ? Vector3d(1, 0, 0)
+		                                                   : Vector3d(0, 1, 0));
+		e1 /= e1.getR();
+		Vector3d e2 = kappa.cross(e1);
+		double psi = 2 * M_PI * random.rand();
+		Vector3d xi = e1 * std::cos(psi) + e2 * std::sin(psi);
+
+		// <cos^2> = 1/2, so the sum of A_n^2 is Brms^2 = 1
+		double a = std::sqrt(2 * A2[n] / sumA2);
+		kx[n] = k * kappa.x;
+		ky[n] = k * kappa.y;
+		kz[n] = k * kappa.z;
+		ax[n] = a * xi.x;
+		ay[n] = a * xi.y;
+		az[n] = a * xi.z;
+		phase[n] = 2 * M_PI * random.rand();
+	}
+}
+
+Vector3d PlaneWaveTurbulence::getUnitField(const Vector3QLength &pos) const {
+	Vector3d r = pos.getValue();
+	const std::size_t nModes = phase.size();
+	const double *kx_ = kx.data(), *ky_ = ky.data(), *kz_ = kz.data();
+	const double *ax_ = ax.data(), *ay_ = ay.data(), *az_ = az.data();
+	const double *phase_ = phase.data();
+
+	// plain loop over the mode arrays, vectorised by the compiler
+	double bx = 0, by = 0, bz = 0;
+	for (std::size_t n = 0; n < nModes; ++n) {
+		double c =
+		    std::cos(kx_[n] * r.x + ky_[n] * r.y + kz_[n] * r.z + phase_[n]);
+		bx += ax_[n] * c;
+		by += ay_[n] * c;
+		bz += az_[n] * c;
+	}
+	return Vector3d(bx, by, bz);
+}
+
+Vector3QMField PlaneWaveTurbulence::getField(const Vector3QLength &pos) const {
+	return getUnitField(pos) * Brms;
+}
+
+void PlaneWaveTurbulence::getFields(
+    const std::vector<Vector3QLength> &positions,
+    std::vector<Vector3QMField> &fields) const {
+	fields.resize(positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+		fields[i] = getUnitField(positions[i]) * Brms;
+}
+
+}}  // namespace hermes::magneticfields
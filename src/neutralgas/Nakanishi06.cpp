@@ -40,4 +40,19 @@ QPDensity Nakanishi06::getPDensity(GasType gas,
 	return QPDensity(0);
 }
 
+void Nakanishi06::getPDensities(GasType gas,
+                                const std::vector<Vector3QLength> &positions,
+                                std::vector<QPDensity> &densities) const {
+	// the gas type is resolved once for all positions
+	densities.assign(positions.size(), QPDensity(0));
+	if (gas == GasType::HI) {
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			densities[i] = getHIDensity(positions[i]);
+	}
+	if (gas == GasType::H2) {
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			densities[i] = getH2Density(positions[i]);
+	}
+}
+
 }}  // namespace hermes::neutralgas
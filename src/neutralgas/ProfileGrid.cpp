@@ -0,0 +1,61 @@
+#include "hermes/neutralgas/ProfileGrid.h"
+
+#include "kiss/logger.h"
+
+namespace hermes { namespace neutralgas {
+
+ProfileGrid::ProfileGrid(const std::shared_ptr<ProfileAbstract> &model_,
+                         const BakedGrid &grid, std::size_t validationPoints)
+    : model(model_),
+      gridHI(grid),
+      gridH2(grid),
+      maxErrorHI(0),
+      maxErrorH2(0) {
+	for (GasType gas : {GasType::HI, GasType::H2}) {
+		auto densities = [this, gas](
+		                     const std::vector<Vector3QLength> &positions,
+		                     std::vector<double> &values) {
+			thread_local std::vector<QPDensity> n;
+			model->getPDensities(gas, positions, n);
+			values.resize(n.size());
+			for (std::size_t i = 0; i < n.size(); ++i)
+				values[i] = static_cast<double>(n[i]);
+		};
+		BakedGrid &baked = (gas == GasType::HI) ? gridHI : gridH2;
+		baked.bake(densities);
+
+		if (validationPoints == 0) continue;
+		double maxValue;
+		QPDensity error(baked.maxError(densities, validationPoints, maxValue));
+		((gas == GasType::HI) ? maxErrorHI : maxErrorH2) = error;
+
+		double error_cm3 = static_cast<double>(error * 1_cm3);
+		double density_cm3 = maxValue * static_cast<double>(1_cm3);
+		KISS_LOG_INFO << "ProfileGrid: "
+		              << ((gas == GasType::HI) ? "HI" : "H2")
+		              << " max. interpolation error " << error_cm3
+		              << " cm^-3, max. density " << density_cm3 << " cm^-3"
+		              << std::endl;
+	}
+}
+
+ProfileGrid::ProfileGrid(const BakedGrid &gridHI_, const BakedGrid &gridH2_)
+    : gridHI(gridHI_), gridH2(gridH2_), maxErrorHI(0), maxErrorH2(0) {}
+
+const BakedGrid &ProfileGrid::getBakedGrid(GasType gas) const {
+	return (gas == GasType::HI) ? gridHI : gridH2;
+}
+
+QPDensity ProfileGrid::getPDensity(GasType gas,
+                                   const Vector3QLength &pos) const {
+	const BakedGrid &grid = getBakedGrid(gas);
+	if (grid.isInside(pos)) return QPDensity(grid.interpolate(pos));
+	if (model) return model->getPDensity(gas, pos);
+	return QPDensity(0);
+}
+
+QPDensity ProfileGrid::getMaxError(GasType gas) const {
+	return (gas == GasType::HI) ? maxErrorHI : maxErrorH2;
+}
+
+}}  // namespace hermes::neutralgas
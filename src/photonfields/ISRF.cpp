@@ -1,16 +1,25 @@
 #include "hermes/photonfields/ISRF.h"
 
+#include <gsl/gsl_eigen.h>
+
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include "hermes/Common.h"
+#include "hermes/GridTools.h"
+#include "hermes/MappedStorage.h"
+#include "kiss/logger.h"
 
 namespace hermes { namespace photonfields {
 
@@ -21,6 +30,21 @@ std::string str(const int &n) {
 }
 
 ISRF::ISRF() {
+	init();
+	std::string binary = getDataPath("RadiationField/Vernetto16.bin");
+	if (std::ifstream(binary.c_str()).good())
+		mapISRF(binary);
+	else
+		loadISRF();
+}
+
+ISRF::ISRF(const std::string &filename) {
+	init();
+	mapISRF(filename);
+}
+
+void ISRF::init() {
+	compressionError = 0;
 	loadFrequencyAxis();
 
 	auto logWavelenghtToFrequency = [](double lambda) {
@@ -42,7 +66,13 @@ ISRF::ISRF() {
 	*/
 
 	buildEnergyRange();
-	loadISRF();
+
+	energyFreqIndex.assign(energyRange.size(), logwavelenghts.size());
+	energyFreqWeight.assign(energyRange.size(), 0);
+	for (std::size_t iE = 0; iE < energyRange.size(); ++iE)
+		if (!getFrequencyIndex(energyRange[iE], energyFreqIndex[iE],
+		                       energyFreqWeight[iE]))
+			energyFreqIndex[iE] = logwavelenghts.size();
 }
 
 void ISRF::buildEnergyRange() {
@@ -70,54 +100,100 @@ void ISRF::loadFrequencyAxis() {
 	}
 }
 
-std::size_t ISRF::getSize() const { return isrf.size(); }
+std::size_t ISRF::getSize() const { return isrfSize; }
 
 void ISRF::loadISRF() {
-	const int max_num_of_char_in_a_line = 512;
-	const int num_of_header_lines = 1;
-
-	int n = 0;
-	for (auto i : r_id) {
-		for (auto j : z_id) {
-			std::ostringstream name;
-			name << "RadiationField/Vernetto16/spectrum_r"
-			     << str(static_cast<int>(i * 10)) << "_z"
-			     << str(static_cast<int>(j * 10)) << ".dat";
-			std::string filename = getDataPath(name.str());
-
-			std::ifstream fin(filename.c_str());
-			if (!fin) {
-				std::stringstream ss;
-				ss << "hermes: error: File " << filename << " not found";
-				throw std::runtime_error(ss.str());
-			}
-			for (std::size_t k = 0; k < num_of_header_lines; ++k) {
-				fin.ignore(max_num_of_char_in_a_line, '\n');
-			}
-			while (!fin.eof()) {
-				double f_, e_;
-				fin >> f_ >> e_;
-				if (!fin.eof()) isrf.push_back(e_);
-			}
-			n++;
+	const std::size_t nFreq = logwavelenghts.size();
+	const std::size_t nFiles = r_id.size() * z_id.size();
+	auto table = std::make_shared<std::vector<double>>(nFiles * nFreq);
+
+	// every file is read at once and parsed with strtod into its own part
+	// of the table; the first line is a header
+	auto parseFile = [this, nFreq, &table](std::size_t n) {
+		std::ostringstream name;
+		name << "RadiationField/Vernetto16/spectrum_r"
+		     << str(static_cast<int>(r_id[n / z_id.size()] * 10)) << "_z"
+		     << str(static_cast<int>(z_id[n % z_id.size()] * 10)) << ".dat";
+		std::string filename = getDataPath(name.str());
+
+		std::ifstream fin(filename.c_str());
+		if (!fin) {
+			std::stringstream ss;
+			ss << "hermes: error: File " << filename << " not found";
+			throw std::runtime_error(ss.str());
 		}
-	}
-	assert(isrf.size() == r_id.size() * z_id.size() * logwavelenghts.size());
+		std::string content((std::istreambuf_iterator<char>(fin)),
+		                    std::istreambuf_iterator<char>());
+
+		const char *p = content.c_str();
+		p = std::strchr(p, '\n');
+		std::size_t k = 0;
+		while (p != nullptr && k < nFreq) {
+			char *end, *next;
+			std::strtod(p, &end);  // wavelength
+			if (end == p) break;
+			double e_ = std::strtod(end, &next);
+			if (next == end) break;
+			(*table)[n * nFreq + k++] = e_;
+			p = next;
+		}
+		if (k != nFreq)
+			throw std::runtime_error("hermes: error: File " + filename +
+			                         " has not the expected number of lines");
+	};
+
+	auto job_chunks = getThreadChunks(nFiles);
+	std::vector<std::thread> threads;
+	std::vector<std::exception_ptr> errors(job_chunks.size());
+	for (std::size_t t = 0; t < job_chunks.size(); ++t)
+		threads.push_back(std::thread([&, t]() {
+			try {
+				for (auto n = job_chunks[t].first; n < job_chunks[t].second;
+				     ++n)
+					parseFile(n);
+			} catch (...) {
+				errors[t] = std::current_exception();
+			}
+		}));
+	for (auto &t : threads) t.join();
+	for (auto &e : errors)
+		if (e) std::rethrow_exception(e);
+
+	isrfSize = table->size();
+	isrf = std::shared_ptr<const double>(table, table->data());
+}
+
+void ISRF::mapISRF(const std::string &filename) {
+	auto storage = std::make_shared<MappedStorage<double>>(filename);
+	const GridFileHeader &header = storage->getHeader();
+	if (header.Nx != r_id.size() || header.Ny != z_id.size() ||
+	    header.Nz != logwavelenghts.size())
+		throw std::runtime_error("ISRF: " + filename +
+		                         " does not match the ISRF table");
+
+	isrfSize = storage->size();
+	isrf = std::shared_ptr<const double>(storage, storage->data());
+}
+
+void ISRF::saveBinary(const std::string &filename) const {
+	// the axes are fixed by the class, origin and spacing are not used
+	Grid<double> table(Vector3d(0.), r_id.size(), z_id.size(),
+	                   logwavelenghts.size(), Vector3d(1.));
+	std::copy(isrf.get(), isrf.get() + isrfSize, table.getGrid().begin());
+	dumpMappedGrid(table, filename);
 }
 
 double ISRF::getISRF(std::size_t ir, std::size_t iz, std::size_t imu) const {
 	std::size_t i = imu + iz * logwavelenghts.size() +
 	                ir * (logwavelenghts.size() * z_id.size());
-	return isrf[i];
+	return isrf.get()[i];
 }
 
 QEnergyDensity ISRF::getEnergyDensity(const Vector3QLength &pos,
                                       std::size_t iE) const {
+	if (energyFreqIndex[iE] == logwavelenghts.size()) return 0;
 	QLength r = sqrt(pos.x * pos.x + pos.y * pos.y);
-	QLength z = pos.z;
-	QEnergy E = energyRange[iE];
-	// TODO(adundovi): not implemented
-	return getEnergyDensity(r, z, E);
+	return interpolate(r, pos.z, energyFreqIndex[iE], energyFreqWeight[iE]);
 }
 
 QEnergyDensity ISRF::getEnergyDensity(const Vector3QLength &pos,
@@ -127,35 +203,52 @@ QEnergyDensity ISRF::getEnergyDensity(const Vector3QLength &pos,
 	return getEnergyDensity(r, z, E_photon);
 }
 
-QEnergyDensity ISRF::getEnergyDensity(const QLength &r, const QLength &z,
-                                      const QEnergy &E_photon) const {
-	double r_ = static_cast<double>(r / 1_kpc);
-	double z_ = static_cast<double>(fabs(z) / 1_kpc);
+bool ISRF::getFrequencyIndex(const QEnergy &E_photon, std::size_t &ifreq,
+                             double &f_d) const {
 	double f_mu =
 	    static_cast<double>(h_planck * c_light / E_photon / (micrometre));
 	double logf_ = std::log10(f_mu);
 
-	if (r_ < r_id.front() || r_ > r_id.back()) return 0;
-	if (z_ < z_id.front() || z_ > z_id.back()) return 0;
 	if (logf_ < logwavelenghts.front() || logf_ > logwavelenghts.back())
-		return 0;
-
-	std::size_t ir =
-	    std::lower_bound(r_id.begin(), r_id.end(), r_) - r_id.begin();
-	std::size_t iz =
-	    std::lower_bound(z_id.begin(), z_id.end(), z_) - z_id.begin();
-	std::size_t ifreq =
-	    std::lower_bound(logwavelenghts.begin(), logwavelenghts.end(), logf_) -
+		return false;
+
+	// lower node of the interval, as in getSpatialIndex()
+	ifreq =
+	    std::upper_bound(logwavelenghts.begin(), logwavelenghts.end(), logf_) -
 	    logwavelenghts.begin() - 1;
+	ifreq = std::min(ifreq, logwavelenghts.size() - 2);
 
-	if (ir == r_id.size()) return 0;
-	if (iz == z_id.size()) return 0;
-	if (ifreq == logwavelenghts.size()) return 0;
+	f_d = (logf_ - logwavelenghts[ifreq]) /
+	      (logwavelenghts[ifreq + 1] - logwavelenghts[ifreq]);
+	return true;
+}
+
+bool ISRF::getSpatialIndex(const QLength &r, const QLength &z,
+                           std::size_t &ir, std::size_t &iz, double &r_d,
+                           double &z_d) const {
+	double r_ = static_cast<double>(r / 1_kpc);
+	double z_ = static_cast<double>(fabs(z) / 1_kpc);
+
+	if (r_ < r_id.front() || r_ > r_id.back()) return false;
+	if (z_ < z_id.front() || z_ > z_id.back()) return false;
 
-	double r_d = (r_ - r_id[ir]) / (r_id[ir + 1] - r_id[ir]);
-	double z_d = (z_ - z_id[iz]) / (z_id[iz + 1] - z_id[iz]);
-	double f_d = (logf_ - logwavelenghts[ifreq]) /
-	             (logwavelenghts[ifreq + 1] - logwavelenghts[ifreq]);
+	// lower node of the cell, the last node belongs to the last cell, so
+	// that 0 <= r_d, z_d <= 1
+	ir = std::upper_bound(r_id.begin(), r_id.end(), r_) - r_id.begin() - 1;
+	iz = std::upper_bound(z_id.begin(), z_id.end(), z_) - z_id.begin() - 1;
+	ir = std::min(ir, r_id.size() - 2);
+	iz = std::min(iz, z_id.size() - 2);
+
+	r_d = (r_ - r_id[ir]) / (r_id[ir + 1] - r_id[ir]);
+	z_d = (z_ - z_id[iz]) / (z_id[iz + 1] - z_id[iz]);
+	return true;
+}
+
+QEnergyDensity ISRF::interpolate(const QLength &r, const QLength &z,
+                                 std::size_t ifreq, double f_d) const {
+	std::size_t ir, iz;
+	double r_d, z_d;
+	if (!getSpatialIndex(r, z, ir, iz, r_d, z_d)) return 0;
 
 	/*
 	if (!(r_d >= 0 && r_d <= 1))
@@ -183,4 +276,168 @@ QEnergyDensity ISRF::getEnergyDensity(const QLength &r, const QLength &z,
 	return c * 1_eV / 1_cm3;
 }
 
+QEnergyDensity ISRF::getEnergyDensity(const QLength &r, const QLength &z,
+                                      const QEnergy &E_photon) const {
+	std::size_t ifreq;
+	double f_d;
+	if (!getFrequencyIndex(E_photon, ifreq, f_d)) return 0;
+	return interpolate(r, z, ifreq, f_d);
+}
+
+void ISRF::getEnergyDensities(const std::vector<Vector3QLength> &positions,
+                              std::size_t iE_,
+                              std::vector<QEnergyDensity> &densities) const {
+	// the frequency interpolation is the same for all positions
+	std::size_t ifreq;
+	double f_d;
+	if (!getFrequencyIndex(energyRange[iE_], ifreq, f_d)) {
+		densities.assign(positions.size(), QEnergyDensity(0));
+		return;
+	}
+
+	densities.resize(positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i) {
+		const Vector3QLength &pos = positions[i];
+		QLength r = sqrt(pos.x * pos.x + pos.y * pos.y);
+		densities[i] = interpolate(r, pos.z, ifreq, f_d);
+	}
+}
+
+void ISRF::getSpectrum(const Vector3QLength &pos,
+                       std::vector<QEnergyDensity> &spectrum) const {
+	spectrum.assign(energyRange.size(), QEnergyDensity(0));
+
+	std::size_t ir, iz;
+	double r_d, z_d;
+	QLength r = sqrt(pos.x * pos.x + pos.y * pos.y);
+	if (!getSpatialIndex(r, pos.z, ir, iz, r_d, z_d)) return;
+
+	// spectra of the four (r, z) neighbours, same arithmetic as interpolate()
+	const std::size_t nFreq = logwavelenghts.size();
+	const double *s00 = isrf.get() + (ir * z_id.size() + iz) * nFreq;
+	const double *s10 = s00 + z_id.size() * nFreq;
+	const double *s01 = s00 + nFreq;
+	const double *s11 = s10 + nFreq;
+	auto spatial = [=](std::size_t k) {
+		double c_0 = s00[k] * (1. - r_d) + s10[k] * r_d;
+		double c_1 = s01[k] * (1. - r_d) + s11[k] * r_d;
+		return std::make_pair(c_0, c_1);
+	};
+
+	for (std::size_t iE = 0; iE < energyRange.size(); ++iE) {
+		std::size_t ifreq = energyFreqIndex[iE];
+		if (ifreq == nFreq) continue;
+		double f_d = energyFreqWeight[iE];
+		auto c0 = spatial(ifreq);
+		auto c1 = spatial(ifreq + 1);
+		double c_0 = c0.first * (1. - z_d) + c0.second * z_d;
+		double c_1 = c1.first * (1. - z_d) + c1.second * z_d;
+		double c = c_0 * (1. - f_d) + c_1 * f_d;
+		spectrum[iE] = c * 1_eV / 1_cm3;
+	}
+}
+
+double ISRF::compress(std::size_t nComponents) {
+	++componentsVersion;
+	componentSpectra.clear();
+	componentWeights.clear();
+	compressionError = 0;
+	if (nComponents == 0) return 0;
+
+	const std::size_t nE = energyRange.size();
+	const std::size_t nFreq = logwavelenghts.size();
+	const std::size_t nNodes = r_id.size() * z_id.size();
+	if (nComponents > nE)
+		throw std::runtime_error(
+		    "ISRF: more components than energies requested");
+
+	// spectra of all (r, z) nodes at the energy axis, in eV/cm3
+	std::vector<double> table(nNodes * nE, 0);
+	for (std::size_t n = 0; n < nNodes; ++n) {
+		const double *s = isrf.get() + n * nFreq;
+		for (std::size_t iE = 0; iE < nE; ++iE) {
+			std::size_t ifreq = energyFreqIndex[iE];
+			if (ifreq == nFreq) continue;
+			double f_d = energyFreqWeight[iE];
+			table[n * nE + iE] = s[ifreq] * (1. - f_d) + s[ifreq + 1] * f_d;
+		}
+	}
+
+	std::vector<double> gram(nE * nE, 0);
+	for (std::size_t n = 0; n < nNodes; ++n) {
+		const double *t = &table[n * nE];
+		for (std::size_t i = 0; i < nE; ++i)
+			for (std::size_t j = i; j < nE; ++j)
+				gram[i * nE + j] += t[i] * t[j];
+	}
+	for (std::size_t i = 0; i < nE; ++i)
+		for (std::size_t j = 0; j < i; ++j) gram[i * nE + j] = gram[j * nE + i];
+
+	// eigenvectors of the Gram matrix, by decreasing eigenvalue; the squared
+	// singular values of the table are its eigenvalues
+	gsl_matrix_view g = gsl_matrix_view_array(gram.data(), nE, nE);
+	gsl_vector *values = gsl_vector_alloc(nE);
+	gsl_matrix *vectors = gsl_matrix_alloc(nE, nE);
+	gsl_eigen_symmv_workspace *workspace = gsl_eigen_symmv_alloc(nE);
+	gsl_eigen_symmv(&g.matrix, values, vectors, workspace);
+	gsl_eigen_symmv_free(workspace);
+	gsl_eigen_symmv_sort(values, vectors, GSL_EIGEN_SORT_VAL_DESC);
+
+	double total = 0, kept = 0;
+	for (std::size_t i = 0; i < nE; ++i) total += gsl_vector_get(values, i);
+	for (std::size_t k = 0; k < nComponents; ++k)
+		kept += gsl_vector_get(values, k);
+
+	componentSpectra.assign(nComponents, std::vector<QEnergyDensity>(nE));
+	componentWeights.assign(nNodes * nComponents, 0);
+	for (std::size_t k = 0; k < nComponents; ++k) {
+		for (std::size_t iE = 0; iE < nE; ++iE)
+			componentSpectra[k][iE] =
+			    gsl_matrix_get(vectors, iE, k) * 1_eV / 1_cm3;
+		for (std::size_t n = 0; n < nNodes; ++n) {
+			double w = 0;
+			for (std::size_t iE = 0; iE < nE; ++iE)
+				w += table[n * nE + iE] * gsl_matrix_get(vectors, iE, k);
+			componentWeights[n * nComponents + k] = w;
+		}
+	}
+	gsl_vector_free(values);
+	gsl_matrix_free(vectors);
+
+	compressionError =
+	    (total > 0) ? std::sqrt(std::max(0., (total - kept) / total)) : 0;
+	KISS_LOG_INFO << "ISRF: " << nComponents
+	              << " components, relative reconstruction error "
+	              << compressionError << std::endl;
+	return compressionError;
+}
+
+const std::vector<QEnergyDensity> &ISRF::getComponentSpectrum(
+    std::size_t k) const {
+	return componentSpectra.at(k);
+}
+
+void ISRF::getComponentWeights(const Vector3QLength &pos,
+                               std::vector<double> &weights) const {
+	const std::size_t nComponents = componentSpectra.size();
+	weights.assign(nComponents, 0);
+
+	std::size_t ir, iz;
+	double r_d, z_d;
+	QLength r = sqrt(pos.x * pos.x + pos.y * pos.y);
+	if (!getSpatialIndex(r, pos.z, ir, iz, r_d, z_d)) return;
+
+	// the weights are interpolated as the spectra in interpolate()
+	const double *w00 =
+	    &componentWeights[(ir * z_id.size() + iz) * nComponents];
+	const double *w10 = w00 + z_id.size() * nComponents;
+	const double *w01 = w00 + nComponents;
+	const double *w11 = w10 + nComponents;
+	for (std::size_t k = 0; k < nComponents; ++k) {
+		double c_0 = w00[k] * (1. - r_d) + w10[k] * r_d;
+		double c_1 = w01[k] * (1. - r_d) + w11[k] * r_d;
+		weights[k] = c_0 * (1. - z_d) + c_1 * z_d;
+	}
+}
+
 }}  // namespace hermes::photonfields
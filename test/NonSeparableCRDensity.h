@@ -0,0 +1,32 @@
+#ifndef HERMES_TEST_NONSEPARABLECRDENSITY_H
+#define HERMES_TEST_NONSEPARABLECRDENSITY_H
+
+#include <memory>
+
+#include "hermes.h"
+
+namespace hermes {
+
+/* Hides the separability of a model, so integrators take the general path */
+class NonSeparableCRDensity : public cosmicrays::CosmicRayDensity {
+  private:
+	std::shared_ptr<cosmicrays::CosmicRayDensity> model;
+
+  public:
+	NonSeparableCRDensity(
+	    const std::shared_ptr<cosmicrays::CosmicRayDensity> &model_)
+	    : model(model_) {
+		energyRange = model->getEnergyAxis();
+		energyScaleFactor = model->getEnergyScaleFactor();
+		scaleFactorFlag = model->existsScaleFactor();
+	}
+	using cosmicrays::CosmicRayDensity::getDensityPerEnergy;
+	QPDensityPerEnergy getDensityPerEnergy(
+	    const QEnergy &E_, const Vector3QLength &pos_) const override {
+		return model->getDensityPerEnergy(E_, pos_);
+	}
+};
+
+}  // namespace hermes
+
+#endif  // HERMES_TEST_NONSEPARABLECRDENSITY_H
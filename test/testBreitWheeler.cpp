@@ -1,3 +1,6 @@
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "hermes.h"
 
@@ -20,6 +23,60 @@ TEST(Interactions, BreitWheeler) {
 	            static_cast<double>(0.01_mbarn));
 }
 
+TEST(Interactions, BreitWheelerTable) {
+	interactions::BreitWheeler table, direct;
+	direct.setUseTable(false);
+	EXPECT_TRUE(table.isUsingTable());
+
+	// {chi - 1/2, integral over theta / sigma_Thompson} from just above the
+	// threshold to 1e11, computed independently with tanh-sinh quadrature
+	// in theta to a relative accuracy of 1e-13
+	const std::vector<std::pair<double, double>> reference = {
+	    {1.000000e-05, 4.71236541488e-05},
+	    {4.700000e-05, 2.21477073576e-04},
+	    {2.209000e-04, 1.04085137050e-03},
+	    {1.038230e-03, 4.88996449701e-03},
+	    {4.879681e-03, 2.29348559999e-02},
+	    {2.293450e-02, 1.06461576459e-01},
+	    {1.077922e-01, 4.55226830576e-01},
+	    {5.066231e-01, 1.20612976108e+00},
+	    {2.381129e+00, 1.14194110776e+00},
+	    {1.119130e+01, 5.13954806253e-01},
+	    {5.259913e+01, 1.71856619001e-01},
+	    {2.472159e+02, 5.04711165779e-02},
+	    {1.161915e+03, 1.37813215781e-02},
+	    {5.461000e+03, 3.58973725397e-03},
+	    {2.566670e+04, 9.04794432585e-04},
+	    {1.206335e+05, 2.22630966923e-04},
+	    {5.669774e+05, 5.37890416672e-05},
+	    {2.664794e+06, 1.28117869384e-05},
+	    {1.252453e+07, 3.01694742588e-06},
+	    {5.886529e+07, 7.03837787799e-07},
+	    {2.766669e+08, 1.62931333610e-07},
+	    {1.300334e+09, 3.74703142884e-08},
+	    {6.111571e+09, 8.56902968302e-09},
+	    {2.872438e+10, 1.95013982732e-09},
+	    {1.350046e+11, 4.41932415339e-10},
+	};
+
+	QEnergy E_gamma = 1_TeV;
+	for (const auto &r : reference) {
+		QEnergy E_ph =
+		    (0.5 + r.first) * 2 * pow<2>(m_electron * c_squared) / E_gamma;
+		QArea res = table.integratedOverTheta(E_gamma, E_ph);
+		EXPECT_NEAR(static_cast<double>(res / sigma_Thompson) / r.second, 1,
+		            1e-4);
+		// the direct integration only aims at 1e-2
+		res = direct.integratedOverTheta(E_gamma, E_ph);
+		EXPECT_NEAR(static_cast<double>(res / sigma_Thompson) / r.second, 1,
+		            1e-2);
+	}
+
+	QEnergy E_threshold = 0.5 * pow<2>(m_electron * c_squared) * 2 / E_gamma;
+	EXPECT_EQ(table.integratedOverTheta(E_gamma, 0.99 * E_threshold),
+	          QArea(0));
+}
+
 TEST(Interactions, BreitWheelerOverCMB) {
 	auto bw = std::make_shared<interactions::BreitWheeler>();
 	auto ph = std::make_shared<photonfields::CMB>();
@@ -1,6 +1,8 @@
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "hermes.h"
@@ -20,6 +22,33 @@ TEST(CacheTools, getValue) {
 	                 static_cast<double>(cache->getValue(a, b)));
 }
 
+TEST(CacheTools, ParameterCache) {
+	ParameterCache<QEnergy, std::vector<double>> cache;
+	int calls = 0;
+	auto f = [&calls](const QEnergy &E) {
+		++calls;
+		return std::vector<double>(3, static_cast<double>(E / 1_GeV));
+	};
+
+	EXPECT_EQ((*cache.get(1_GeV, f))[0], 1);
+	EXPECT_EQ((*cache.get(1_GeV, f))[2], 1);
+	EXPECT_EQ(calls, 1);
+	auto first = cache.get(1_GeV, f);
+	EXPECT_EQ((*cache.get(2_GeV, f))[0], 2);
+	EXPECT_EQ(calls, 2);
+	EXPECT_EQ((*first)[0], 1);  // still valid after a recomputation
+
+	// threads asking for the same parameter share one computation
+	cache.clear();
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 8; ++i)
+		threads.push_back(std::thread([&cache, &f]() {
+			for (int j = 0; j < 100; ++j) cache.get(3_GeV, f);
+		}));
+	for (auto &t : threads) t.join();
+	EXPECT_EQ(calls, 3);
+}
+
 TEST(CacheTools, Kamae06Gamma) {
 	auto cache =
 	    std::make_unique<CacheStorageCrossSection>(CacheStorageCrossSection());
@@ -63,6 +92,8 @@ TEST(CacheTools, Kamae06Gamma) {
 TEST(CacheTools, BremsstrahlungGALPROP) {
 	auto f_brem = std::make_shared<interactions::BremsstrahlungGALPROP>(
 	    interactions::BremsstrahlungGALPROP());
+	// the hash cache against the direct calculation
+	f_brem->disableTable();
 
 	QDiffCrossSection integral_cached(0), integral_noncached(0);
 	QEnergy E_proton = 10_GeV;
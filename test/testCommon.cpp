@@ -106,6 +106,38 @@ TEST(Common, intensityToTemperature) {
 	EXPECT_NEAR(static_cast<double>(temp), 3.2548e39, 1e36);
 }
 
+TEST(Common, CounterRandom) {
+	// known answers of Philox4x32-10 (Random123)
+	uint32_t out[4];
+	CounterRandom(0).block(0, 0, out);
+	EXPECT_EQ(out[0], 0x6627e8d5u);
+	EXPECT_EQ(out[1], 0xe169c58du);
+	EXPECT_EQ(out[2], 0xbc57ac4cu);
+	EXPECT_EQ(out[3], 0x9b00dbd8u);
+	CounterRandom(0x299f31d0a4093822ull)
+	    .block(0x85a308d3243f6a88ull, 0x0370734413198a2eull, out);
+	EXPECT_EQ(out[0], 0xd16cfe09u);
+	EXPECT_EQ(out[1], 0x94fdccebu);
+	EXPECT_EQ(out[2], 0x5001e420u);
+	EXPECT_EQ(out[3], 0x24126ea1u);
+
+	CounterRandom random(42);
+	double sum = 0, sum2 = 0;
+	int n = 100000;
+	for (int i = 0; i < n; ++i) {
+		double u = random.rand(i);
+		EXPECT_GT(u, 0);
+		EXPECT_LT(u, 1);
+		sum += u;
+		random.block(i, 1, out);
+		double x = CounterRandom::toNormal(out[0], out[1]);
+		sum2 += x * x;
+	}
+	EXPECT_NEAR(sum / n, 0.5, 0.01);
+	EXPECT_NEAR(sum2 / n, 1, 0.02);
+	EXPECT_EQ(random.rand(123), CounterRandom(42).rand(123));
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
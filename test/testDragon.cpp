@@ -0,0 +1,362 @@
+#ifdef HERMES_HAVE_CFITSIO
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "hermes.h"
+
+namespace hermes {
+
+// synthetic flux in the DRAGON file units, E running fastest
+float syntheticFlux(int species, std::size_t iE, std::size_t ix,
+                    std::size_t iy, std::size_t iz) {
+	return species * 1000 + iE + 0.1 * ix + 0.01 * iy + 0.001 * iz;
+}
+
+// a spatial axis of the synthetic DRAGON file
+struct SyntheticAxis {
+	std::string name;
+	double min, max;
+	int dim;
+};
+
+// axes {r, z} for a 2D and {x, y, z} for a 3D file, x or r running fastest
+// after E
+void writeSyntheticDragon(const std::string &filename, int dimE,
+                          const std::vector<SyntheticAxis> &axes) {
+	auto ffile = std::make_unique<FITSFile>(FITSFile("!" + filename));
+	ffile->createFile();
+	long nullnaxes[1] = {1};
+	float nullArray[1] = {0};
+	ffile->createImage(FITS::IMGFLOAT, 1, nullnaxes);
+	ffile->writeImage(FITS::FLOAT, 1, 1, nullArray);
+
+	std::vector<std::pair<std::string, double>> doubleKeys = {
+	    {"Ekmin", 1.}, {"Ekin_fac", 1.5}};
+	std::vector<std::pair<std::string, int>> intKeys = {{"dimE", dimE}};
+	std::vector<long> naxes = {dimE};
+	for (auto &axis : axes) {
+		doubleKeys.push_back({axis.name + "min", axis.min});
+		doubleKeys.push_back({axis.name + "max", axis.max});
+		intKeys.push_back({"dim" + axis.name, axis.dim});
+		naxes.push_back(axis.dim);
+	}
+	for (auto &k : doubleKeys) {
+		auto kv = FITSKeyValue(k.first, k.second);
+		ffile->writeKeyValue(kv, "");
+	}
+	for (auto &k : intKeys) {
+		auto kv = FITSKeyValue(k.first, k.second);
+		ffile->writeKeyValue(kv, "");
+	}
+
+	std::size_t nPoints = 1;
+	for (auto &axis : axes) nPoints *= axis.dim;
+
+	// one HDU per species: protons and helium
+	std::vector<PID> species = {Proton, Helium};
+	for (std::size_t s = 0; s < species.size(); ++s) {
+		ffile->createImage(FITS::IMGFLOAT, naxes.size(), naxes.data());
+		auto Z = FITSKeyValue("Z_", species[s].atomicNr());
+		ffile->writeKeyValue(Z, "");
+		auto A = FITSKeyValue("A", species[s].massNr());
+		ffile->writeKeyValue(A, "");
+
+		std::vector<float> data;
+		data.reserve(dimE * nPoints);
+		std::vector<std::size_t> index(axes.size());
+		for (std::size_t n = 0; n < nPoints; ++n) {
+			for (std::size_t a = 0, rest = n; a < axes.size(); ++a) {
+				index[a] = rest % axes[a].dim;
+				rest /= axes[a].dim;
+			}
+			std::size_t iy = (axes.size() == 3) ? index[1] : 0;
+			for (int iE = 0; iE < dimE; ++iE)
+				data.push_back(syntheticFlux(s + 1, iE, index.front(), iy,
+				                             index.back()));
+		}
+		ffile->writeImage(FITS::FLOAT, 1, data.size(), data.data());
+	}
+	ffile->closeFile();
+}
+
+TEST(Dragon2D, syntheticCube) {
+	std::string filename = "testDragon2D_small.fits";
+	int dimE = 5, dimr = 13, dimz = 7;
+	writeSyntheticDragon(filename, dimE,
+	                     {{"r", 0., 12., dimr}, {"z", -2., 2., dimz}});
+
+	// the r slabs are scattered by several threads
+	auto load = [&filename](const char *threads) {
+		setenv("HERMES_NUM_THREADS", threads, 1);
+		auto dragon =
+		    std::make_shared<cosmicrays::Dragon2D>(filename, Proton);
+		unsetenv("HERMES_NUM_THREADS");
+		return dragon;
+	};
+	auto dragon = load("4");
+	auto single = load("1");
+	auto energies = dragon->getEnergyAxis();
+	ASSERT_EQ(energies.size(), dimE);
+	EXPECT_NEAR(static_cast<double>(energies[0] / 1_GeV), 1., 1e-12);
+
+	const double fluxToDensity = static_cast<double>(4_pi / (c_light * 1_GeV));
+	QLength dr = 12_kpc / (dimr - 1), dz = 4_kpc / (dimz - 1);
+	std::vector<QPDensityPerEnergy> spectrum, expectedSpectrum;
+	for (int ir = 0; ir < dimr - 2; ++ir)
+		for (int iz = 1; iz < dimz - 1; ++iz) {
+			// the grid starts at -rmax and is periodic, so the node ir is
+			// at rho = (ir + 1.5) dr
+			Vector3QLength pos((ir + 1.5) * dr, 0_kpc,
+			                   -2_kpc + (iz + 0.5) * dz);
+			dragon->getSpectrum(pos, spectrum);
+			single->getSpectrum(pos, expectedSpectrum);
+			EXPECT_EQ(spectrum, expectedSpectrum);
+			for (int iE = 0; iE < dimE; ++iE) {
+				QPDensityPerEnergy expected(fluxToDensity *
+				                            syntheticFlux(1, iE, ir, 0, iz));
+				EXPECT_NEAR(static_cast<double>(spectrum[iE] / expected), 1,
+				            1e-5);
+				EXPECT_EQ(dragon->getDensityPerEnergy(iE, pos), spectrum[iE]);
+				EXPECT_EQ(dragon->getDensityPerEnergy(energies[iE], pos),
+				          spectrum[iE]);
+			}
+		}
+
+	// cylindrical symmetry, zero outside of the model volume
+	QPDensityPerEnergy onAxis = dragon->getDensityPerEnergy(
+	    std::size_t(1), Vector3QLength(5_kpc, 0_kpc, 0.5_kpc));
+	EXPECT_NEAR(static_cast<double>(
+	                dragon->getDensityPerEnergy(
+	                    std::size_t(1), Vector3QLength(3_kpc, 4_kpc, 0.5_kpc)) /
+	                onAxis),
+	            1, 1e-12);
+	dragon->getSpectrum(Vector3QLength(13_kpc, 0_kpc, 0_kpc), spectrum);
+	EXPECT_EQ(spectrum, std::vector<QPDensityPerEnergy>(
+	                        dimE, QPDensityPerEnergy(0)));
+
+	std::remove(filename.c_str());
+}
+
+TEST(Dragon2D, energyWindow) {
+	std::string filename = "testDragon2D_window.fits";
+	int dimE = 12, dimr = 9, dimz = 5;
+	writeSyntheticDragon(filename, dimE,
+	                     {{"r", 0., 12., dimr}, {"z", -2., 2., dimz}});
+
+	std::vector<PID> species = {Proton, Helium};
+	auto full = std::make_shared<cosmicrays::Dragon2D>(filename, species);
+	auto energies = full->getEnergyAxis();
+
+	// [E_4, E_7] plus one neighbouring bin on each side
+	auto window = std::make_shared<cosmicrays::Dragon2D>(
+	    filename, species, energies[4] * 0.99, energies[7] * 1.01);
+	auto windowEnergies = window->getEnergyAxis();
+	ASSERT_EQ(windowEnergies.size(), 6);
+	for (std::size_t i = 0; i < windowEnergies.size(); ++i)
+		EXPECT_EQ(windowEnergies[i], energies[i + 3]);
+
+	// bins above Egamma, as used by the pi0 integrator, are unchanged
+	QEnergy Egamma = energies[5] * 1.1;
+	EXPECT_EQ(*window->beginAfterEnergy(Egamma),
+	          *full->beginAfterEnergy(Egamma));
+
+	Vector3QLength pos(1.2_kpc, -3.4_kpc, 0.3_kpc);
+	for (std::size_t i = 0; i < windowEnergies.size(); ++i) {
+		EXPECT_EQ(window->getDensityPerEnergy(i, pos),
+		          full->getDensityPerEnergy(i + 3, pos));
+		EXPECT_EQ(window->getDensityPerEnergy(windowEnergies[i], pos),
+		          full->getDensityPerEnergy(windowEnergies[i], pos));
+	}
+	EXPECT_THROW(window->getDensityPerEnergy(energies[0], pos),
+	             std::out_of_range);
+
+	// the summed species are part of the window grid
+	EXPECT_GT(window->getDensityPerEnergy(std::size_t(0), pos),
+	          cosmicrays::Dragon2D(filename, Proton).getDensityPerEnergy(
+	              std::size_t(3), pos));
+
+	EXPECT_THROW(cosmicrays::Dragon2D(filename, species, energies.back() * 2),
+	             std::runtime_error);
+
+	std::remove(filename.c_str());
+}
+
+TEST(Dragon3D, syntheticCube) {
+	std::string filename = "testDragon3D_small.fits";
+	int dimE = 5, dimx = 11, dimy = 9, dimz = 7;
+	writeSyntheticDragon(filename, dimE,
+	                     {{"x", -10., 10., dimx},
+	                      {"y", -10., 10., dimy},
+	                      {"z", -2., 2., dimz}});
+
+	auto dragon = std::make_shared<cosmicrays::Dragon3D>(filename, Proton);
+	auto energies = dragon->getEnergyAxis();
+	ASSERT_EQ(energies.size(), dimE);
+	EXPECT_NEAR(static_cast<double>(energies[0] / 1_GeV), 1., 1e-12);
+
+	const double fluxToDensity = static_cast<double>(4_pi / (c_light * 1_GeV));
+	QLength dx = 20_kpc / (dimx - 1), dy = 20_kpc / (dimy - 1),
+	        dz = 4_kpc / (dimz - 1);
+	std::vector<QPDensityPerEnergy> spectrum;
+	for (int ix = 2; ix < dimx - 2; ++ix)
+		for (int iy = 2; iy < dimy - 2; ++iy)
+			for (int iz = 1; iz < dimz - 1; ++iz) {
+				// grid points lie in the middle of the cells
+				Vector3QLength pos(-10_kpc + (ix + 0.5) * dx,
+				                   -10_kpc + (iy + 0.5) * dy,
+				                   -2_kpc + (iz + 0.5) * dz);
+				dragon->getSpectrum(pos, spectrum);
+				for (int iE = 0; iE < dimE; ++iE) {
+					QPDensityPerEnergy expected(
+					    fluxToDensity * syntheticFlux(1, iE, ix, iy, iz));
+					EXPECT_NEAR(static_cast<double>(spectrum[iE] / expected),
+					            1, 1e-5);
+					EXPECT_EQ(dragon->getDensityPerEnergy(iE, pos),
+					          spectrum[iE]);
+					EXPECT_EQ(dragon->getDensityPerEnergy(energies[iE], pos),
+					          spectrum[iE]);
+				}
+			}
+
+	std::remove(filename.c_str());
+}
+
+TEST(Dragon3D, energyWindow) {
+	std::string filename = "testDragon3D_window.fits";
+	int dimE = 12, dimx = 9, dimy = 9, dimz = 5;
+	writeSyntheticDragon(filename, dimE,
+	                     {{"x", -10., 10., dimx},
+	                      {"y", -10., 10., dimy},
+	                      {"z", -2., 2., dimz}});
+
+	std::vector<PID> species = {Proton, Helium};
+	auto full = std::make_shared<cosmicrays::Dragon3D>(filename, species);
+	auto energies = full->getEnergyAxis();
+
+	// [E_4, E_7] plus one neighbouring bin on each side
+	auto window = std::make_shared<cosmicrays::Dragon3D>(
+	    filename, species, energies[4] * 0.99, energies[7] * 1.01);
+	auto windowEnergies = window->getEnergyAxis();
+	ASSERT_EQ(windowEnergies.size(), 6);
+	for (std::size_t i = 0; i < windowEnergies.size(); ++i)
+		EXPECT_EQ(windowEnergies[i], energies[i + 3]);
+
+	// bins above Egamma, as used by the pi0 integrator, are unchanged
+	QEnergy Egamma = energies[5] * 1.1;
+	EXPECT_EQ(*window->beginAfterEnergy(Egamma),
+	          *full->beginAfterEnergy(Egamma));
+
+	Vector3QLength pos(1.2_kpc, -3.4_kpc, 0.3_kpc);
+	for (std::size_t i = 0; i < windowEnergies.size(); ++i) {
+		EXPECT_EQ(window->getDensityPerEnergy(i, pos),
+		          full->getDensityPerEnergy(i + 3, pos));
+		EXPECT_EQ(window->getDensityPerEnergy(windowEnergies[i], pos),
+		          full->getDensityPerEnergy(windowEnergies[i], pos));
+	}
+	EXPECT_THROW(window->getDensityPerEnergy(energies[0], pos),
+	             std::out_of_range);
+
+	// the summed species are part of the window grid
+	EXPECT_GT(window->getDensityPerEnergy(std::size_t(0), pos),
+	          cosmicrays::Dragon3D(filename, Proton).getDensityPerEnergy(
+	              std::size_t(3), pos));
+
+	EXPECT_THROW(cosmicrays::Dragon3D(filename, species, energies.back() * 2),
+	             std::runtime_error);
+
+	std::remove(filename.c_str());
+}
+
+TEST(Dragon3D, projectileWeights) {
+	std::string filename = "testDragon3D_weights.fits";
+	writeSyntheticDragon(filename, 4,
+	                     {{"x", -10., 10., 7},
+	                      {"y", -10., 10., 7},
+	                      {"z", -2., 2., 5}});
+
+	auto protons = std::make_shared<cosmicrays::Dragon3D>(filename, Proton);
+	auto helium = std::make_shared<cosmicrays::Dragon3D>(filename, Helium);
+	std::map<PID, double> weights = {{Proton, 1.4}, {Helium, 5.1}};
+	auto weighted = std::make_shared<cosmicrays::Dragon3D>(filename, weights);
+	EXPECT_FALSE(protons->isProjectileWeighted());
+	EXPECT_TRUE(weighted->isProjectileWeighted());
+	EXPECT_EQ(weighted->getProjectileWeights(), weights);
+	EXPECT_THROW(cosmicrays::Dragon3D(filename, std::map<PID, double>()),
+	             std::runtime_error);
+
+	std::vector<QPDensityPerEnergy> p, he, w;
+	Vector3QLength pos(2.1_kpc, -0.7_kpc, 0.2_kpc);
+	protons->getSpectrum(pos, p);
+	helium->getSpectrum(pos, he);
+	weighted->getSpectrum(pos, w);
+	ASSERT_EQ(w.size(), 4);
+	for (std::size_t i = 0; i < w.size(); ++i)
+		EXPECT_NEAR(static_cast<double>(w[i] / (1.4 * p[i] + 5.1 * he[i])), 1,
+		            1e-12);
+
+	std::remove(filename.c_str());
+}
+
+TEST(Dragon3D, getDensitiesPerEnergy) {
+	std::string filename = "testDragon3D_batch.fits";
+	writeSyntheticDragon(filename, 4,
+	                     {{"x", -10., 10., 9},
+	                      {"y", -10., 10., 9},
+	                      {"z", -2., 2., 5}});
+	auto dragon = std::make_shared<cosmicrays::Dragon3D>(filename, Proton);
+
+	std::vector<Vector3QLength> positions;
+	for (int i = 0; i < 50; ++i)
+		positions.push_back(Vector3QLength(0.5_kpc * (i - 25),
+		                                   0.3_kpc * (i % 20) - 3_kpc,
+		                                   0.1_kpc * (i % 50) - 2.5_kpc));
+
+	std::vector<QPDensityPerEnergy> densities;
+	dragon->getDensitiesPerEnergy(std::size_t(2), positions, densities);
+	ASSERT_EQ(densities.size(), positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+		EXPECT_EQ(densities[i],
+		          dragon->getDensityPerEnergy(std::size_t(2), positions[i]));
+
+	std::remove(filename.c_str());
+}
+
+TEST(Dragon3D, LoadPerformanceTest) {
+	std::string filename = "testDragon3D_large.fits";
+	int dimE = 32, dimx = 101, dimy = 101, dimz = 41;
+	writeSyntheticDragon(filename, dimE,
+	                     {{"x", -10., 10., dimx},
+	                      {"y", -10., 10., dimy},
+	                      {"z", -2., 2., dimz}});
+
+	auto start = std::chrono::system_clock::now();
+	auto dragon = std::make_shared<cosmicrays::Dragon3D>(
+	    filename, std::vector<PID>{Proton, Helium});
+	auto stop = std::chrono::system_clock::now();
+	auto milliseconds =
+	    std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+	std::cerr << "loading 2 x " << dimE << "x" << dimx << "x" << dimy << "x"
+	          << dimz << " cube: " << milliseconds.count() << " ms"
+	          << std::endl;
+
+	// both species are summed up
+	QLength dx = 20_kpc / (dimx - 1);
+	Vector3QLength pos(-10_kpc + 50.5 * dx, -10_kpc + 50.5 * dx, 0.05_kpc);
+	EXPECT_GT(dragon->getDensityPerEnergy(std::size_t(0), pos),
+	          QPDensityPerEnergy(0));
+
+	std::remove(filename.c_str());
+}
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+}  // namespace hermes
+
+#endif  // HERMES_HAVE_CFITSIO
@@ -0,0 +1,378 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "hermes.h"
+#include "hermes/neutralgas/Nakanishi06.h"
+
+namespace hermes {
+
+TEST(Grid, BrickedLayoutIndex) {
+	// sizes which are not multiples of the brick size
+	BrickedLayout<4> layout;
+	size_t Nx = 7, Ny = 5, Nz = 9;
+	layout.setGridSize(Nx, Ny, Nz);
+	EXPECT_EQ(layout.getStorageSize(), 2 * 2 * 3 * 64);
+
+	std::vector<bool> used(layout.getStorageSize(), false);
+	for (size_t ix = 0; ix < Nx; ix++)
+		for (size_t iy = 0; iy < Ny; iy++)
+			for (size_t iz = 0; iz < Nz; iz++) {
+				size_t i = layout.index(ix, iy, iz);
+				ASSERT_LT(i, layout.getStorageSize());
+				EXPECT_FALSE(used[i]);
+				used[i] = true;
+
+				size_t jx, jy, jz;
+				layout.indexToPoint(i, jx, jy, jz);
+				EXPECT_EQ(ix, jx);
+				EXPECT_EQ(iy, jy);
+				EXPECT_EQ(iz, jz);
+			}
+}
+
+TEST(Grid, BrickedLayoutSameValues) {
+	Vector3d origin(-1, 2, 0.5);
+	ScalarGrid linear(origin, 19, 13, 10, 0.3);
+	BrickedScalarGrid bricked(origin, 19, 13, 10, 0.3);
+	EXPECT_EQ(bricked.getGridSize(), linear.getGridSize());
+	EXPECT_EQ(bricked.getStorageSize(), 3 * 2 * 2 * 512);
+
+	Random random;
+	random.seed(42);
+	for (size_t ix = 0; ix < 19; ix++)
+		for (size_t iy = 0; iy < 13; iy++)
+			for (size_t iz = 0; iz < 10; iz++) {
+				float v = random.rand();
+				linear.get(ix, iy, iz) = v;
+				bricked.setValue(ix, iy, iz, v);
+			}
+
+	for (bool reflective : {false, true}) {
+		linear.setReflective(reflective);
+		bricked.setReflective(reflective);
+		for (int i = 0; i < 1000; i++) {
+			Vector3d pos = origin + Vector3d(random.randUniform(-3, 9),
+			                                 random.randUniform(-3, 7),
+			                                 random.randUniform(-3, 6));
+			EXPECT_FLOAT_EQ(linear.interpolate(pos), bricked.interpolate(pos));
+		}
+	}
+	linear.setReflective(false);
+	bricked.setReflective(false);
+	for (int i = 0; i < 1000; i++) {
+		Vector3d pos = origin + Vector3d(random.randUniform(0, 5.7),
+		                                 random.randUniform(0, 3.9),
+		                                 random.randUniform(0, 3));
+		EXPECT_FLOAT_EQ(linear.closestValue(pos), bricked.closestValue(pos));
+	}
+
+	// conversion between layouts and positions of storage indices
+	ScalarGrid copy(bricked);
+	for (size_t i = 0; i < copy.getStorageSize(); i++)
+		EXPECT_EQ(copy.get(i), linear.get(i));
+	for (size_t i = 0; i < 50; i++) {
+		Vector3d pos = linear.positionFromIndex(i);
+		EXPECT_FLOAT_EQ(bricked.closestValue(pos), linear.get(i));
+	}
+}
+
+TEST(Grid, SpectralGrid) {
+	Vector3d origin(-2, 0, 1);
+	Vector3d spacing(0.5, 0.25, 1);
+	size_t NE = 6;
+	SpectralGrid<float> spectral(origin, 5, 4, 3, NE, spacing);
+	std::vector<std::unique_ptr<ScalarGrid>> grids;
+	for (size_t iE = 0; iE < NE; ++iE)
+		grids.push_back(
+		    std::make_unique<ScalarGrid>(origin, 5, 4, 3, spacing));
+
+	Random random;
+	random.seed(5);
+	for (size_t ix = 0; ix < 5; ix++)
+		for (size_t iy = 0; iy < 4; iy++)
+			for (size_t iz = 0; iz < 3; iz++)
+				for (size_t iE = 0; iE < NE; ++iE) {
+					float v = random.rand();
+					spectral.addValue(ix, iy, iz, iE, v);
+					grids[iE]->get(ix, iy, iz) = v;
+				}
+
+	std::vector<float> spectrum;
+	for (int i = 0; i < 100; i++) {
+		Vector3d pos = origin + Vector3d(random.randUniform(-1, 3),
+		                                 random.randUniform(-1, 2),
+		                                 random.randUniform(-1, 4));
+		spectral.getSpectrum(pos, spectrum);
+		ASSERT_EQ(spectrum.size(), NE);
+		for (size_t iE = 0; iE < NE; ++iE) {
+			EXPECT_FLOAT_EQ(spectrum[iE], grids[iE]->interpolate(pos));
+			EXPECT_FLOAT_EQ(spectral.interpolate(pos, iE), spectrum[iE]);
+		}
+	}
+}
+
+template <typename G>
+double sampleRandomRays(const G &grid, double size, int nRays, int nSteps,
+                        double &sum) {
+	Random random;
+	random.seed(1234);
+	sum = 0;
+	auto start = std::chrono::system_clock::now();
+	for (int i = 0; i < nRays; i++) {
+		Vector3d pos(random.rand(size), random.rand(size), random.rand(size));
+		Vector3d step = random.randVector() * (size / nSteps);
+		for (int j = 0; j < nSteps; j++) {
+			sum += grid.interpolate(pos).getR();
+			pos += step;
+		}
+	}
+	auto stop = std::chrono::system_clock::now();
+	return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+TEST(Grid, BrickedLayoutPerformanceTest) {
+	// a turbulent-field like vector grid, 192^3 * 12 bytes = 85 MB,
+	// sampled along random rays with about one step per cell
+	size_t N = 192;
+	double spacing = 1;
+	VectorGrid linear(Vector3d(0.), N, spacing);
+	Random random;
+	random.seed(7);
+	for (size_t ix = 0; ix < N; ix++)
+		for (size_t iy = 0; iy < N; iy++)
+			for (size_t iz = 0; iz < N; iz++)
+				linear.get(ix, iy, iz) = Vector3f(random.randVector());
+	BrickedVectorGrid bricked(linear);
+
+	double sumLinear, sumBricked;
+	double tLinear =
+	    sampleRandomRays(linear, N * spacing, 20000, N, sumLinear);
+	double tBricked =
+	    sampleRandomRays(bricked, N * spacing, 20000, N, sumBricked);
+
+	std::cerr << "random LOS rays, linear: " << tLinear
+	          << " ms, bricked: " << tBricked
+	          << " ms, speedup: " << tLinear / tBricked << std::endl;
+
+	EXPECT_DOUBLE_EQ(sumLinear, sumBricked);
+}
+
+TEST(Grid, MappedGrid) {
+	std::string filename = "testGrid_mapped.bin";
+	VectorGrid grid(Vector3d(1, -2, 3), 9, 7, 5, Vector3d(0.5, 1, 2));
+	grid.setReflective(true);
+	Random random;
+	random.seed(3);
+	for (size_t ix = 0; ix < 9; ix++)
+		for (size_t iy = 0; iy < 7; iy++)
+			for (size_t iz = 0; iz < 5; iz++)
+				grid.get(ix, iy, iz) = Vector3f(random.randVector());
+	dumpMappedGrid(grid, filename);
+
+	auto mapped = loadMappedGrid<Vector3f>(filename);
+	EXPECT_EQ(mapped->getNx(), 9);
+	EXPECT_EQ(mapped->getNy(), 7);
+	EXPECT_EQ(mapped->getNz(), 5);
+	EXPECT_TRUE(mapped->isReflective());
+	EXPECT_EQ(mapped->getOrigin(), grid.getOrigin());
+	EXPECT_EQ(mapped->getSpacing(), grid.getSpacing());
+	for (int i = 0; i < 100; i++) {
+		Vector3d pos(random.randUniform(-5, 10), random.randUniform(-5, 10),
+		             random.randUniform(-5, 15));
+		EXPECT_EQ(mapped->interpolate(pos), grid.interpolate(pos));
+	}
+
+	// writable mapping: changes end up in the file
+	auto writable = loadMappedGrid<Vector3f>(filename, true);
+	writable->get(0, 0, 0) = Vector3f(0.);
+	EXPECT_EQ(mapped->get(0, 0, 0), Vector3f(0.));
+	EXPECT_EQ(loadMappedGrid<Vector3f>(filename)->get(0, 0, 0),
+	          Vector3f(0.));
+
+	EXPECT_THROW(loadMappedGrid<float>(filename), std::runtime_error);
+	EXPECT_THROW(loadMappedGrid<float>("testGrid_missing.bin"),
+	             std::runtime_error);
+	std::remove(filename.c_str());
+
+	// the unit of quantities is part of the element type
+	Grid<QPDensity> density(Vector3d(0.), 3, 1);
+	density.get(1, 2, 0) = 0.5 / 1_cm3;
+	dumpMappedGrid(density, filename);
+	EXPECT_EQ(loadMappedGrid<QPDensity>(filename)->get(1, 2, 0),
+	          0.5 / 1_cm3);
+	EXPECT_THROW(loadMappedGrid<QEnergy>(filename), std::runtime_error);
+	EXPECT_THROW(loadMappedGrid<double>(filename), std::runtime_error);
+	std::remove(filename.c_str());
+}
+
+TEST(Grid, MappedGridPerformanceTest) {
+	std::string filename = "testGrid_mapped_large.bin";
+	size_t N = 128;
+	ScalarGrid grid(Vector3d(0.), N, 1);
+	for (size_t i = 0; i < grid.getStorageSize(); i++) grid.get(i) = i;
+	dumpMappedGrid(grid, filename);
+
+	auto start = std::chrono::system_clock::now();
+	auto mapped = loadMappedGrid<float>(filename);
+	auto stop = std::chrono::system_clock::now();
+	auto microseconds =
+	    std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+	std::cerr << "mapping " << N << "^3 grid: " << microseconds.count()
+	          << " us" << std::endl;
+
+	EXPECT_EQ(mapped->get(N - 1, N - 1, N - 1), grid.get(N - 1, N - 1, N - 1));
+	EXPECT_LE(microseconds.count(), 10000);
+	std::remove(filename.c_str());
+}
+
+TEST(Grid, BakedGrid) {
+	// trilinear functions are reproduced exactly by the interpolation
+	auto linear = [](const std::vector<Vector3QLength> &positions,
+	                 std::vector<double> &values) {
+		values.resize(positions.size());
+		for (std::size_t i = 0; i < positions.size(); ++i) {
+			Vector3d r = positions[i].getValue() / static_cast<double>(1_kpc);
+			values[i] = 10 + 2 * r.x - r.y + 3 * r.z;
+		}
+	};
+
+	std::vector<QLength> zAxis = {-2_kpc, -0.5_kpc, -0.1_kpc, 0_kpc,
+	                              0.05_kpc, 0.3_kpc, 1.5_kpc};
+	BakedGrid uniform(Vector3QLength(-2_kpc, -1_kpc, -1_kpc), 8, 6, 5,
+	                  Vector3QLength(0.5_kpc, 0.4_kpc, 0.25_kpc));
+	BakedGrid nonUniform(Vector3QLength(-2_kpc, -1_kpc, 0_kpc), 8, 6,
+	                     Vector3QLength(0.5_kpc), zAxis);
+	EXPECT_TRUE(uniform.isUniform());
+	EXPECT_FALSE(nonUniform.isUniform());
+	EXPECT_EQ(nonUniform.getNz(), zAxis.size());
+	Vector3QLength node(-1.25_kpc, 0.25_kpc, 0.05_kpc);
+	EXPECT_LT((nonUniform.getPosition(1, 2, 4) - node).getR(), 1e-6_pc);
+
+	std::vector<double> values;
+	for (BakedGrid *grid : {&uniform, &nonUniform}) {
+		grid->bake(linear);
+		std::vector<Vector3QLength> nodes = {grid->getPosition(3, 2, 1)};
+		linear(nodes, values);
+		EXPECT_FLOAT_EQ(grid->getGrid()->get(3, 2, 1), values[0]);
+
+		double maxValue;
+		double error = grid->maxError(linear, 1000, maxValue);
+		EXPECT_LT(error, 1e-5 * maxValue);
+		EXPECT_GT(maxValue, 10);
+	}
+
+	EXPECT_TRUE(nonUniform.isInside(Vector3QLength(0_kpc, 0_kpc, -2_kpc)));
+	EXPECT_TRUE(nonUniform.isInside(Vector3QLength(0_kpc, 0_kpc, 1.5_kpc)));
+	EXPECT_FALSE(nonUniform.isInside(Vector3QLength(0_kpc, 0_kpc, 1.6_kpc)));
+	// first and last grid planes are half a cell inside the volume
+	EXPECT_FALSE(uniform.isInside(Vector3QLength(-1.9_kpc, 0_kpc, 0_kpc)));
+	EXPECT_TRUE(uniform.isInside(Vector3QLength(-1.75_kpc, 0_kpc, 0_kpc)));
+
+	// copies do not share the values
+	BakedGrid copy(nonUniform);
+	copy.getGrid()->get(0, 0, 0) = -1;
+	EXPECT_NE(nonUniform.getGrid()->get(0, 0, 0), -1);
+
+	EXPECT_THROW(BakedGrid(Vector3QLength(0_kpc), 8, 6,
+	                       Vector3QLength(0.5_kpc), {1_kpc, 0_kpc}),
+	             std::runtime_error);
+}
+
+TEST(Grid, ChargedGasDensityGrid) {
+	auto model = std::make_shared<chargedgas::HII_Cordes91>();
+
+	// planes close to the thin disk, as many as in the uniform grid
+	std::vector<QLength> zAxis;
+	for (double z : {-2., -1., -0.6, -0.4, -0.3, -0.2, -0.15, -0.1, -0.05,
+	                 -0.025})
+		zAxis.push_back(z * 1_kpc);
+	zAxis.push_back(0_kpc);
+	for (int i = 9; i >= 0; --i) zAxis.push_back(-zAxis[i]);
+
+	QLength dz = 4_kpc / (zAxis.size() - 1);
+	BakedGrid uniform(Vector3QLength(-12_kpc, -12_kpc, -2_kpc - dz / 2), 48,
+	                  48, zAxis.size(), Vector3QLength(0.5_kpc, 0.5_kpc, dz));
+	BakedGrid nonUniform(Vector3QLength(-12_kpc, -12_kpc, 0_kpc), 48, 48,
+	                     Vector3QLength(0.5_kpc), zAxis);
+	chargedgas::ChargedGasDensityGrid bakedUniform(model, uniform);
+	chargedgas::ChargedGasDensityGrid baked(model, nonUniform);
+
+	EXPECT_EQ(baked.getTemperature(), model->getTemperature());
+	EXPECT_LT(baked.getMaxError(), 0.05 * baked.getMaxDensity());
+	EXPECT_LT(baked.getMaxError(), 0.2 * bakedUniform.getMaxError());
+
+	// outside of the grid the model is used
+	Vector3QLength outside(1_kpc, 2_kpc, 3_kpc);
+	EXPECT_EQ(baked.getDensity(outside), model->getDensity(outside));
+	Vector3QLength inside(3_kpc, -4_kpc, 0.07_kpc);
+	EXPECT_NEAR(static_cast<double>(baked.getDensity(inside) /
+	                                model->getDensity(inside)),
+	            1, 0.05);
+
+	// persisted grid
+	std::string filename = "testGrid_baked.bin";
+	dumpGrid(baked.getGrid(), filename);
+	BakedGrid loaded(nonUniform);
+	loadGrid(loaded.getGrid(), filename);
+	chargedgas::ChargedGasDensityGrid fromFile(loaded);
+	EXPECT_EQ(fromFile.getDensity(inside), baked.getDensity(inside));
+	EXPECT_EQ(fromFile.getDensity(outside), QPDensity(0));
+	std::remove(filename.c_str());
+}
+
+TEST(Grid, ProfileGrid) {
+	auto model = std::make_shared<neutralgas::Nakanishi06>();
+	std::vector<QLength> zAxis;
+	for (int i = -20; i <= 20; ++i) zAxis.push_back(0.01_kpc * i * abs(i));
+	BakedGrid grid(Vector3QLength(-16_kpc, -16_kpc, 0_kpc), 65, 65,
+	               Vector3QLength(0.5_kpc), zAxis);
+	neutralgas::ProfileGrid baked(model, grid, 1000);
+
+	Vector3QLength pos(-2_kpc, 6_kpc, 0.02_kpc);
+	for (auto gas : {neutralgas::GasType::HI, neutralgas::GasType::H2}) {
+		EXPECT_GT(baked.getMaxError(gas), QPDensity(0));
+		EXPECT_NEAR(static_cast<double>(baked.getPDensity(gas, pos) /
+		                                model->getPDensity(gas, pos)),
+		            1, 0.1);
+	}
+	EXPECT_NE(baked.getGrid(neutralgas::GasType::HI),
+	          baked.getGrid(neutralgas::GasType::H2));
+}
+
+#ifdef HERMES_HAVE_FFTW3F
+TEST(Grid, initTurbulence) {
+	auto turbulence = [](const char *threads) {
+		setenv("HERMES_NUM_THREADS", threads, 1);
+		auto grid =
+		    std::make_shared<VectorGrid>(VectorGrid(Vector3d(0.), 32, 1));
+		initTurbulence(grid, 2, 2, 16, -11. / 3., 42);
+		return grid;
+	};
+	auto single = turbulence("1");
+	auto parallel = turbulence("4");
+	unsetenv("HERMES_NUM_THREADS");
+
+	// the k-space modes only depend on the seed; a multi-threaded FFT may
+	// sum in another order, so the grids agree to float precision only
+	EXPECT_NEAR(rmsFieldStrength(single), 2, 1e-4);
+	EXPECT_LT(meanFieldVector(single).getR(), 0.1);
+	for (size_t ix = 0; ix < 32; ix += 5)
+		for (size_t iy = 0; iy < 32; iy += 3)
+			for (size_t iz = 0; iz < 32; ++iz) {
+				Vector3f a = single->get(ix, iy, iz);
+				Vector3f b = parallel->get(ix, iy, iz);
+				EXPECT_NEAR(a.x, b.x, 1e-5);
+				EXPECT_NEAR(a.y, b.y, 1e-5);
+				EXPECT_NEAR(a.z, b.z, 1e-5);
+			}
+}
+#endif  // HERMES_HAVE_FFTW3F
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
+
+}  // namespace hermes
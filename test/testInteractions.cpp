@@ -91,6 +91,23 @@ TEST(Interactions, KelnerAharonianVsKamae06Neutrino) {
 	    static_cast<double>(5e-21));
 }
 
+TEST(Interactions, ProjectileWeights) {
+	auto kamae = std::make_shared<interactions::Kamae06Gamma>(
+	    interactions::Kamae06Gamma());
+	std::vector<std::pair<PID, double>> targets = {{Proton, 0.9},
+	                                               {Helium, 0.1}};
+	auto weights = kamae->getProjectileWeights({Proton, Helium}, targets);
+
+	ASSERT_EQ(weights.size(), 2);
+	EXPECT_DOUBLE_EQ(weights[Proton], 0.9 * 1.0 + 0.1 * 3.81);
+	EXPECT_DOUBLE_EQ(weights[Helium], 0.9 * 3.68 + 0.1 * 14.2);
+
+	EXPECT_NO_THROW(kamae->checkProjectileWeights(weights, targets));
+	weights[Helium] *= 1.01;
+	EXPECT_THROW(kamae->checkProjectileWeights(weights, targets),
+	             std::runtime_error);
+}
+
 TEST(Interactions, KleinNishina) {
 	auto interaction = std::make_shared<interactions::KleinNishina>(
 	    interactions::KleinNishina());
@@ -165,6 +182,77 @@ TEST(Interactions, BremsstrahlungGALPROP) {
 	EXPECT_NEAR(static_cast<double>(res), 35.8892, 1e-1);
 }
 
+TEST(Interactions, BremsstrahlungGALPROPTable) {
+	interactions::BremsstrahlungGALPROP direct, tabulated;
+	EXPECT_TRUE(tabulated.isTableEnabled());
+	direct.disableCaching();
+	direct.disableTable();
+	EXPECT_FALSE(direct.isTableEnabled());
+	tabulated.disableCaching();
+
+	// all energy regimes and both ends of the photon spectrum
+	for (auto t : direct.allTargets) {
+		for (QEnergy Eelectron :
+		     {0.03_MeV, 0.5_MeV, 1.9_MeV, 30_MeV, 10_GeV, 1e4_GeV}) {
+			for (double y : {1e-6, 1e-3, 0.1, 0.5, 0.9, 0.9999}) {
+				QEnergy Egamma = y * Eelectron;
+				double expected = static_cast<double>(
+				    direct.getDiffCrossSectionForTarget(t, Eelectron, Egamma));
+				double value = static_cast<double>(
+				    tabulated.getDiffCrossSectionForTarget(t, Eelectron,
+				                                           Egamma));
+				EXPECT_NEAR(value / expected, 1, 1e-3);
+			}
+		}
+	}
+
+	// kinematic limit and below the cut-off
+	auto t = interactions::BremsstrahlungAbstract::Target::HI;
+	EXPECT_EQ(static_cast<double>(
+	              tabulated.getDiffCrossSectionForTarget(t, 1_GeV, 1_GeV)),
+	          0);
+	EXPECT_EQ(static_cast<double>(tabulated.getDiffCrossSectionForTarget(
+	              t, 0.005_MeV, 0.001_MeV)),
+	          0);
+}
+
+TEST(Interactions, BremsstrahlungTsai74) {
+	interactions::BremsstrahlungTsai74 i;
+	auto H = interactions::BremsstrahlungAbstract::Target::HI;
+	auto He = interactions::BremsstrahlungAbstract::Target::He;
+
+	// the complete screening limit at y -> 0:
+	// E dsigma/dE = 4 alpha r_e^2 (4/3 (Z^2 (F_el - f) + Z F_inel) +
+	// (Z^2 + Z) / 9), with the Coulomb corrections f(1) = 6.4008e-5 and
+	// f(2) = 2.5600e-4 of Tsai's Eq. 3.46
+	QEnergy Eelectron = 1e4_GeV;
+	QEnergy Egamma = 1_MeV;
+	QArea unit = 4 * alpha_fine * pow<2>(r_electron);
+	QArea res = Egamma * i.getDiffCrossSectionForTarget(H, Eelectron, Egamma);
+	EXPECT_NEAR(static_cast<double>(res / unit), 15.19240, 1e-4);
+	res = Egamma * i.getDiffCrossSectionForTarget(He, Eelectron, Egamma);
+	EXPECT_NEAR(static_cast<double>(res / unit), 41.19730, 1e-4);
+
+	// radiation length of hydrogen, 63.04 g/cm^2 (PDG), which uses Tsai's
+	// F_inel = 6.144 rather than the Dirac-Fock value of 5.9173:
+	// E dsigma/dE -> 4/3 A / (X_0 N_A) + 4 alpha r_e^2 (Z^2 + Z) / 9
+	QArea fromX0 = 4. / 3. * 1.00794 / (63.04 * 6.02214076e23) * 1_cm2 +
+	               2. / 9. * unit;
+	res = Egamma * i.getDiffCrossSectionForTarget(H, Eelectron, Egamma);
+	EXPECT_NEAR(static_cast<double>(res / fromX0), 1, 0.03);
+
+	// He differs from H, HI and HII agree
+	EXPECT_GT(i.getDiffCrossSectionForTarget(He, Eelectron, Egamma),
+	          i.getDiffCrossSectionForTarget(H, Eelectron, Egamma));
+	EXPECT_EQ(i.getDiffCrossSectionForTarget(
+	              interactions::BremsstrahlungAbstract::Target::HII,
+	              Eelectron, Egamma),
+	          i.getDiffCrossSectionForTarget(H, Eelectron, Egamma));
+	EXPECT_EQ(static_cast<double>(
+	              i.getDiffCrossSectionForTarget(H, 1_GeV, 1_GeV)),
+	          0);
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
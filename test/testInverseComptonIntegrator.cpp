@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "hermes.h"
+#include "NonSeparableCRDensity.h"
 
 namespace hermes {
 
@@ -111,6 +112,95 @@ TEST(InverseComptonIntegrator, compareLOSIntegrations) {
 	            1e-5);
 }
 
+/* The kernel of separable CR models gives the same emissivity */
+TEST(InverseComptonIntegrator, separableModel) {
+	auto simpleModel = std::make_shared<cosmicrays::SimpleCRDensity>(
+	    cosmicrays::SimpleCRDensity());
+	auto general = std::make_shared<NonSeparableCRDensity>(simpleModel);
+	auto kleinnishina = std::make_shared<interactions::KleinNishina>(
+	    interactions::KleinNishina());
+	auto photonField = std::make_shared<photonfields::CMB>(photonfields::CMB());
+	auto intSeparable = std::make_shared<InverseComptonIntegrator>(
+	    InverseComptonIntegrator(simpleModel, photonField, kleinnishina));
+	auto intGeneral = std::make_shared<InverseComptonIntegrator>(
+	    InverseComptonIntegrator(general, photonField, kleinnishina));
+
+	for (QEnergy Egamma : {1_GeV, 100_GeV, 1_GeV}) {
+		for (QLength z : {0_kpc, 0.3_kpc, -2_kpc}) {
+			Vector3QLength pos(-4_kpc, 2_kpc, z);
+			auto expected = intGeneral->integrateOverEnergy(pos, Egamma);
+			auto emissivity = intSeparable->integrateOverEnergy(pos, Egamma);
+			EXPECT_NEAR(static_cast<double>(emissivity / expected), 1, 1e-9);
+		}
+	}
+}
+
+/* The kernel matrix gives the sum over integrateOverPhotonEnergy() */
+TEST(InverseComptonIntegrator, kernelMatrix) {
+	auto simpleModel = std::make_shared<cosmicrays::SimpleCRDensity>(
+	    cosmicrays::SimpleCRDensity());
+	auto general = std::make_shared<NonSeparableCRDensity>(simpleModel);
+	auto kleinnishina = std::make_shared<interactions::KleinNishina>(
+	    interactions::KleinNishina());
+	auto isrf = std::make_shared<photonfields::ISRF>(photonfields::ISRF());
+	auto intIC = std::make_shared<InverseComptonIntegrator>(
+	    InverseComptonIntegrator(general, isrf, kleinnishina));
+
+	Vector3QLength pos(-4_kpc, 2_kpc, 0.2_kpc);
+	for (QEnergy Egamma : {1_GeV, 30_GeV}) {
+		std::vector<QPDensityPerEnergy> spectrum;
+		general->getSpectrum(pos, spectrum);
+		QGREmissivity expected(0);
+		auto itN = spectrum.begin();
+		for (auto itE = general->begin(); itE != general->end();
+		     ++itE, ++itN)
+			expected += intIC->integrateOverPhotonEnergy(pos, Egamma, *itE) *
+			            (*itN) * (*itE) * c_light;
+		expected = expected * log(general->getEnergyScaleFactor());
+
+		auto emissivity = intIC->integrateOverEnergy(pos, Egamma);
+		EXPECT_NEAR(static_cast<double>(emissivity / expected), 1, 1e-9);
+	}
+}
+
+/* An ISRF decomposed into all of its components gives the emissivity of
+ * the full one */
+TEST(InverseComptonIntegrator, lowRankPhotonField) {
+	auto simpleModel = std::make_shared<cosmicrays::SimpleCRDensity>(
+	    cosmicrays::SimpleCRDensity());
+	auto general = std::make_shared<NonSeparableCRDensity>(simpleModel);
+	auto kleinnishina = std::make_shared<interactions::KleinNishina>(
+	    interactions::KleinNishina());
+	auto isrf = std::make_shared<photonfields::ISRF>(photonfields::ISRF());
+	auto lowRank = std::make_shared<photonfields::ISRF>(photonfields::ISRF());
+	auto intFull = std::make_shared<InverseComptonIntegrator>(
+	    InverseComptonIntegrator(general, isrf, kleinnishina));
+	auto intLowRank = std::make_shared<InverseComptonIntegrator>(
+	    InverseComptonIntegrator(general, lowRank, kleinnishina));
+
+	lowRank->compress(lowRank->getEnergyAxis().size());
+	for (QEnergy Egamma : {1_GeV, 100_GeV}) {
+		for (QLength z : {0_kpc, 0.3_kpc, -2_kpc}) {
+			Vector3QLength pos(-4_kpc, 2_kpc, z);
+			auto expected = intFull->integrateOverEnergy(pos, Egamma);
+			auto emissivity = intLowRank->integrateOverEnergy(pos, Egamma);
+			EXPECT_NEAR(static_cast<double>(emissivity / expected), 1, 1e-6);
+		}
+	}
+
+	// the component kernels follow a decomposition done after their use
+	Vector3QLength pos(-4_kpc, 2_kpc, 0.3_kpc);
+	auto expected = intFull->integrateOverEnergy(pos, 1_GeV);
+	std::size_t version = lowRank->getComponentsVersion();
+	lowRank->compress(2);
+	EXPECT_GT(lowRank->getComponentsVersion(), version);
+	intLowRank->integrateOverEnergy(pos, 1_GeV);
+	lowRank->compress(lowRank->getEnergyAxis().size());
+	EXPECT_NEAR(static_cast<double>(
+	                intLowRank->integrateOverEnergy(pos, 1_GeV) / expected),
+	            1, 1e-6);
+}
+
 /*
 TEST(InverseComptonIntegrator, integrateOverLOS) {
     auto simpleModel = std::make_shared<SimpleCRDensity>(SimpleCRDensity());
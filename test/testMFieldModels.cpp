@@ -15,6 +15,168 @@ TEST(Sun08, disk) {
 	EXPECT_DOUBLE_EQ(static_cast<double>(B1.y), static_cast<double>(-B2.y));
 }
 
+TEST(JF12, getFields) {
+	auto jf12 =
+	    std::make_shared<magneticfields::JF12>(magneticfields::JF12());
+	jf12->randomStriated(7);
+
+	std::vector<Vector3QLength> positions;
+	for (int i = 0; i < 200; ++i)
+		positions.push_back(Vector3QLength(0.1_kpc * (i - 100),
+		                                   0.07_kpc * (i % 50) - 1.5_kpc,
+		                                   0.05_kpc * (i % 20) - 0.5_kpc));
+
+	std::vector<Vector3QMField> fields;
+	for (bool striated : {false, true}) {
+		jf12->setUseStriated(striated);
+		jf12->getFields(positions, fields);
+		ASSERT_EQ(fields.size(), positions.size());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			EXPECT_EQ(fields[i], jf12->getField(positions[i]));
+	}
+}
+
+TEST(JF12, randomStriated) {
+	auto striated = [](const char *threads) {
+		setenv("HERMES_NUM_THREADS", threads, 1);
+		magneticfields::JF12 jf12;
+		jf12.randomStriated(17);
+		return jf12.getStriatedGrid();
+	};
+	auto single = striated("1");
+	auto parallel = striated("4");
+	unsetenv("HERMES_NUM_THREADS");
+
+	EXPECT_EQ(single->getGrid(), parallel->getGrid());
+	double mean = 0;
+	for (float f : single->getGrid()) {
+		EXPECT_EQ(std::fabs(f), 1);
+		mean += f;
+	}
+	EXPECT_LT(std::fabs(mean / single->getGrid().size()), 0.01);
+}
+
+TEST(JF12, BakedMagneticField) {
+	auto jf12 =
+	    std::make_shared<magneticfields::JF12>(magneticfields::JF12());
+	jf12->randomStriated(7);
+	auto turbulent = std::make_shared<VectorGrid>(
+	    VectorGrid(Vector3d(0.), 16, static_cast<double>(50_pc)));
+	Random random;
+	random.seed(3);
+	for (std::size_t i = 0; i < turbulent->getGrid().size(); ++i)
+		turbulent->getGrid()[i] = Vector3f(random.randNorm(),
+		                                   random.randNorm(),
+		                                   random.randNorm());
+	jf12->setTurbulentGrid(turbulent);
+
+	Vector3QLength origin(-20_kpc, -20_kpc, -4_kpc);
+	Vector3QLength spacing(0.5_kpc, 0.5_kpc, 0.25_kpc);
+	auto baked = std::make_shared<magneticfields::BakedMagneticField>(
+	    jf12, origin, 80, 80, 32, spacing, 1000);
+	EXPECT_GT(baked->getMaxField(), 0_muG);
+
+	// at the grid points the baked field is the model field
+	for (int i = 1; i < 40; ++i) {
+		Vector3QLength node =
+		    origin + spacing * 0.5 +
+		    Vector3QLength(1_kpc * i, 0.5_kpc * (i % 31), 0.25_kpc * (i % 25));
+		Vector3QMField expected = jf12->getField(node);
+		EXPECT_LT((baked->getField(node) - expected).getR(),
+		          1e-6 * expected.getR() + 1e-6_muG);
+	}
+
+	// outside of the grid the model is used
+	Vector3QLength outside(3_kpc, 1_kpc, 5_kpc);
+	EXPECT_TRUE(baked->isInside(Vector3QLength(3_kpc, 1_kpc, 3_kpc)));
+	EXPECT_FALSE(baked->isInside(outside));
+	EXPECT_EQ(baked->getField(outside), jf12->getField(outside));
+
+	// a JF12 passed as MagneticField is baked the same way
+	std::shared_ptr<magneticfields::MagneticField> generic = jf12;
+	magneticfields::BakedMagneticField bakedGeneric(generic, origin, 80, 80,
+	                                                32, spacing, 0);
+	for (int i = 1; i < 40; ++i) {
+		Vector3QLength pos(0.9_kpc * i - 18_kpc, 0.3_kpc * (i % 17),
+		                   0.1_kpc * (i % 13) - 0.6_kpc);
+		EXPECT_EQ(bakedGeneric.getField(pos), baked->getField(pos));
+	}
+
+	// any field: a smooth one is reproduced within the interpolation error
+	auto uniform = std::make_shared<magneticfields::UniformMagneticField>(
+	    Vector3QMField(1_muG, -2_muG, 0.5_muG));
+	magneticfields::BakedMagneticField bakedUniform(uniform, origin, 4, 4, 4,
+	                                                spacing, 100);
+	EXPECT_LT(bakedUniform.getMaxError(), 1e-9_muG);
+	Vector3QLength pos = origin + spacing * 2.;
+	EXPECT_LT((bakedUniform.getField(pos) - uniform->getField(pos)).getR(),
+	          1e-9_muG);
+}
+
+TEST(PlaneWaveTurbulence, statistics) {
+	auto turbulence = std::make_shared<magneticfields::PlaneWaveTurbulence>(
+	    3_muG, 8_pc, 272_pc, 500, 11);
+	EXPECT_EQ(turbulence->getNumberOfModes(), 500);
+
+	Random random;
+	random.seed(5);
+	double sumB2 = 0;
+	Vector3d sumB(0.);
+	int n = 20000;
+	for (int i = 0; i < n; ++i) {
+		Vector3QLength pos(Vector3d(random.randUniform(-1, 1),
+		                            random.randUniform(-1, 1),
+		                            random.randUniform(-1, 1)) *
+		                   static_cast<double>(10_kpc));
+		Vector3d b = turbulence->getField(pos).getValue();
+		sumB2 += b.getR2();
+		sumB += b;
+	}
+	double Brms = static_cast<double>(3_muG);
+	EXPECT_NEAR(std::sqrt(sumB2 / n) / Brms, 1, 0.05);
+	EXPECT_LT((sumB / n).getR() / Brms, 0.05);
+
+	// divergence free
+	Vector3QLength pos(1_kpc, -2_kpc, 0.3_kpc);
+	QLength h = 0.01_pc;
+	QMField div = turbulence->getField(pos + Vector3QLength(h, 0_m, 0_m)).x -
+	              turbulence->getField(pos - Vector3QLength(h, 0_m, 0_m)).x +
+	              turbulence->getField(pos + Vector3QLength(0_m, h, 0_m)).y -
+	              turbulence->getField(pos - Vector3QLength(0_m, h, 0_m)).y +
+	              turbulence->getField(pos + Vector3QLength(0_m, 0_m, h)).z -
+	              turbulence->getField(pos - Vector3QLength(0_m, 0_m, h)).z;
+	EXPECT_LT(fabs(div), 1e-6 * 3_muG);
+
+	// same seed, same modes
+	magneticfields::PlaneWaveTurbulence again(3_muG, 8_pc, 272_pc, 500, 11);
+	EXPECT_EQ(again.getField(pos), turbulence->getField(pos));
+}
+
+TEST(JF12, turbulentModes) {
+	auto jf12 =
+	    std::make_shared<magneticfields::JF12>(magneticfields::JF12());
+	auto modes = std::make_shared<magneticfields::PlaneWaveTurbulence>(
+	    1_T, 8_pc, 272_pc, 200, 3);
+	jf12->setTurbulentModes(modes);
+	EXPECT_TRUE(jf12->isUsingTurbulent());
+
+	Vector3QLength pos(4_kpc, 1_kpc, 0.1_kpc);
+	Vector3QMField b = jf12->getTurbulentField(pos);
+	Vector3QMField expected =
+	    modes->getUnitField(pos) * jf12->getTurbulentStrength(pos);
+	EXPECT_EQ(b, expected);
+	EXPECT_GT(b.getR(), 0_muG);
+
+	// the baked JF12 adds the same modes to its baked Brms profile
+	Vector3QLength origin(-10_kpc, -10_kpc, -2_kpc);
+	Vector3QLength spacing(0.25_kpc, 0.25_kpc, 0.25_kpc);
+	magneticfields::BakedMagneticField baked(jf12, origin, 80, 80, 16,
+	                                         spacing, 0);
+	Vector3QLength node = origin + spacing * 20.5;
+	Vector3QMField full = jf12->getField(node);
+	EXPECT_LT((baked.getField(node) - full).getR(), 1e-6 * full.getR());
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <cstdio>
 #include <fstream>
 
 #include "gtest/gtest.h"
@@ -51,6 +53,158 @@ TEST(CMB, ISRF) {
 	*/
 }
 
+TEST(ISRF, getEnergyDensities) {
+	auto isrf = std::make_shared<photonfields::ISRF>(photonfields::ISRF());
+
+	std::vector<Vector3QLength> positions;
+	for (int i = 0; i < 100; ++i)
+		positions.push_back(Vector3QLength(0.3_kpc * (i - 50),
+		                                   0.2_kpc * (i % 30) - 3_kpc,
+		                                   0.1_kpc * (i % 10) - 0.5_kpc));
+
+	std::vector<QEnergyDensity> densities;
+	for (std::size_t iE = 0; iE < isrf->getEnergyAxis().size(); iE += 37) {
+		isrf->getEnergyDensities(positions, iE, densities);
+		ASSERT_EQ(densities.size(), positions.size());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+			EXPECT_EQ(densities[i], isrf->getEnergyDensity(positions[i], iE));
+	}
+}
+
+TEST(ISRF, getSpectrum) {
+	auto isrf = std::make_shared<photonfields::ISRF>(photonfields::ISRF());
+	auto cmb = std::make_shared<photonfields::CMB>(photonfields::CMB());
+
+	std::vector<Vector3QLength> positions = {
+	    Vector3QLength(8.5_kpc, 0_kpc, 0_kpc),
+	    Vector3QLength(-2.3_kpc, 3.1_kpc, 0.45_kpc),
+	    Vector3QLength(0.1_kpc, 0_kpc, -1.2_kpc),
+	    Vector3QLength(40_kpc, 0_kpc, 0_kpc)};
+	std::vector<QEnergyDensity> spectrum;
+	for (auto &pos : positions) {
+		for (auto field : {std::static_pointer_cast<photonfields::PhotonField>(
+		                       isrf),
+		                   std::static_pointer_cast<photonfields::PhotonField>(
+		                       cmb)}) {
+			field->getSpectrum(pos, spectrum);
+			ASSERT_EQ(spectrum.size(), field->getEnergyAxis().size());
+			for (std::size_t iE = 0; iE < spectrum.size(); ++iE)
+				EXPECT_EQ(spectrum[iE], field->getEnergyDensity(pos, iE));
+		}
+	}
+}
+
+TEST(ISRF, outerCells) {
+	photonfields::ISRF isrf;
+	std::size_t iE = isrf.getEnergyAxis().size() / 2;
+	auto u = [&isrf, iE](QLength r, QLength z) {
+		return static_cast<double>(
+		    isrf.getEnergyDensity(Vector3QLength(r, 0_kpc, z), iE) /
+		    (1_eV / 1_cm3));
+	};
+
+	// the last cells, r in [25, 30] kpc and |z| in [25, 30] kpc, are
+	// interpolated between their own nodes
+	EXPECT_GT(u(25_kpc, 0_kpc), 0);
+	EXPECT_GT(u(30_kpc, 0_kpc), 0);
+	EXPECT_NEAR(u(27_kpc, 0_kpc),
+	            0.6 * u(25_kpc, 0_kpc) + 0.4 * u(30_kpc, 0_kpc),
+	            1e-12 * u(25_kpc, 0_kpc));
+	EXPECT_NEAR(u(8.5_kpc, 27_kpc),
+	            0.6 * u(8.5_kpc, 25_kpc) + 0.4 * u(8.5_kpc, 30_kpc),
+	            1e-12 * u(8.5_kpc, 25_kpc));
+	EXPECT_EQ(u(30.1_kpc, 0_kpc), 0);
+
+	// the spectra and the component weights use the same cells
+	std::vector<QEnergyDensity> spectrum;
+	std::vector<double> weights;
+	isrf.compress(3);
+	for (auto pos : {Vector3QLength(27_kpc, 0_kpc, 0_kpc),
+	                 Vector3QLength(0_kpc, 30_kpc, 0_kpc),
+	                 Vector3QLength(30_kpc, 0_kpc, -30_kpc)}) {
+		isrf.getSpectrum(pos, spectrum);
+		for (std::size_t i = 0; i < spectrum.size(); ++i)
+			EXPECT_EQ(spectrum[i], isrf.getEnergyDensity(pos, i));
+		isrf.getComponentWeights(pos, weights);
+		ASSERT_EQ(weights.size(), 3);
+		EXPECT_NE(weights[0], 0);
+	}
+}
+
+TEST(ISRF, compress) {
+	photonfields::ISRF isrf;
+	const std::size_t nE = isrf.getEnergyAxis().size();
+	EXPECT_EQ(isrf.getNumberOfComponents(), 0);
+
+	// the error decreases with the number of components
+	double error = 1;
+	for (std::size_t n : {1, 3, 6}) {
+		double e = isrf.compress(n);
+		EXPECT_EQ(isrf.getNumberOfComponents(), n);
+		EXPECT_LE(e, error);
+		error = e;
+	}
+
+	// all components reproduce the field between the nodes as well
+	EXPECT_LT(isrf.compress(nE), 1e-6);
+	std::vector<Vector3QLength> positions = {
+	    Vector3QLength(8.5_kpc, 0_kpc, 0_kpc),
+	    Vector3QLength(-2.3_kpc, 3.1_kpc, 0.45_kpc),
+	    Vector3QLength(0.1_kpc, 0.7_kpc, -1.2_kpc)};
+	std::vector<double> weights;
+	std::vector<QEnergyDensity> spectrum;
+	for (auto &pos : positions) {
+		isrf.getComponentWeights(pos, weights);
+		isrf.getSpectrum(pos, spectrum);
+		ASSERT_EQ(weights.size(), nE);
+		QEnergyDensity maxDensity(0);
+		for (auto &u : spectrum) maxDensity = std::max(maxDensity, u);
+		for (std::size_t iE = 0; iE < nE; ++iE) {
+			QEnergyDensity u(0);
+			for (std::size_t k = 0; k < nE; ++k)
+				u += weights[k] * isrf.getComponentSpectrum(k)[iE];
+			EXPECT_NEAR(static_cast<double>(u / maxDensity),
+			            static_cast<double>(spectrum[iE] / maxDensity), 1e-6);
+		}
+	}
+
+	isrf.compress(0);
+	EXPECT_EQ(isrf.getNumberOfComponents(), 0);
+}
+
+TEST(ISRF, LoadPerformanceTest) {
+	auto milliseconds = [](std::chrono::system_clock::time_point start) {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(
+		           std::chrono::system_clock::now() - start)
+		    .count();
+	};
+
+	// text files, unless RadiationField/Vernetto16.bin is installed
+	auto start = std::chrono::system_clock::now();
+	photonfields::ISRF text;
+	auto textTime = milliseconds(start);
+
+	std::string filename = "test_isrf.bin";
+	text.saveBinary(filename);
+	start = std::chrono::system_clock::now();
+	photonfields::ISRF binary(filename);
+	auto binaryTime = milliseconds(start);
+
+	std::cerr << "ISRF startup: default " << textTime << " ms, binary "
+	          << binaryTime << " ms" << std::endl;
+
+	ASSERT_EQ(binary.getSize(), text.getSize());
+	std::vector<Vector3QLength> positions = {
+	    Vector3QLength(8.5_kpc, 0_kpc, 0_kpc),
+	    Vector3QLength(-2_kpc, 3_kpc, 0.4_kpc),
+	    Vector3QLength(0.1_kpc, 0_kpc, -1.2_kpc)};
+	for (std::size_t iE = 0; iE < text.getEnergyAxis().size(); iE += 17)
+		for (auto &pos : positions)
+			EXPECT_EQ(binary.getEnergyDensity(pos, iE),
+			          text.getEnergyDensity(pos, iE));
+	std::remove(filename.c_str());
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
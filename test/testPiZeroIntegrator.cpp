@@ -103,6 +103,39 @@ TEST(PiZeroIntegrator, ChannelsRatio) {
 	            static_cast<double>(res_total), 1e-22);
 }
 
+/* Densities on different energy axes get a kernel each */
+TEST(PiZeroIntegrator, MixedEnergyAxes) {
+	auto cr_proton = std::make_shared<cosmicrays::SimpleCRDensity>(
+	    cosmicrays::SimpleCRDensity(Proton));
+	auto cr_helium = std::make_shared<cosmicrays::SimpleCRDensity>(
+	    cosmicrays::SimpleCRDensity(Helium, 2_GeV, 1e5_GeV, 17));
+	EXPECT_FALSE(cr_proton->hasSameEnergyAxis(*cr_helium));
+	std::vector<std::shared_ptr<cosmicrays::CosmicRayDensity>> cr_all = {
+	    cr_helium, cr_proton, cr_helium};
+
+	auto kamae = std::make_shared<interactions::Kamae06Gamma>(
+	    interactions::Kamae06Gamma());
+	auto ringModel = std::make_shared<neutralgas::RingModel>(
+	    neutralgas::RingModel(neutralgas::GasType::HI));
+	auto intPiZero_proton = std::make_shared<PiZeroIntegrator>(
+	    PiZeroIntegrator(cr_proton, ringModel, kamae));
+	auto intPiZero_helium = std::make_shared<PiZeroIntegrator>(
+	    PiZeroIntegrator(cr_helium, ringModel, kamae));
+	auto intPiZero_total = std::make_shared<PiZeroIntegrator>(
+	    PiZeroIntegrator(cr_all, ringModel, kamae));
+
+	Vector3QLength pos(8.5_kpc, 0, 0);
+	for (QEnergy Egamma : {1_GeV, 10_GeV, 1_TeV}) {
+		double expected = static_cast<double>(
+		    intPiZero_proton->integrateOverEnergy(pos, Egamma) +
+		    2. * intPiZero_helium->integrateOverEnergy(pos, Egamma));
+		double total = static_cast<double>(
+		    intPiZero_total->integrateOverEnergy(pos, Egamma));
+		EXPECT_GT(expected, 0);
+		EXPECT_NEAR(total / expected, 1, 1e-12);
+	}
+}
+
 TEST(PiZeroIntegrator, PiZeroLOS) {
 	// auto crdensity =
 	// std::make_shared<TestCRDensity>(TestCRDensity(1_MHz));
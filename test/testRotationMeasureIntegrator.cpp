@@ -1,4 +1,5 @@
 #include <chrono>
+#include <cmath>
 #include <memory>
 
 #include "gtest/gtest.h"
@@ -74,6 +75,22 @@ TEST(RotationMeasureIntegrator, Orientation) {
 	}
 }
 
+TEST(RotationMeasureIntegrator, StaticDispatch) {
+	auto magfield = std::make_shared<TestMagneticField>(TestMagneticField());
+	auto gasdensity =
+	    std::make_shared<TestChargedGasDensity>(TestChargedGasDensity());
+	auto dynamic = std::make_shared<RotationMeasureIntegrator>(
+	    RotationMeasureIntegrator(magfield, gasdensity));
+	auto fixed = std::make_shared<RotationMeasureIntegratorT<
+	    TestMagneticField, TestChargedGasDensity>>(magfield, gasdensity);
+
+	for (std::size_t ipix = 0; ipix < 192; ipix += 7) {
+		QDirection direction = pix2ang_ring(4, ipix);
+		EXPECT_EQ(fixed->integrateOverLOS(direction),
+		          dynamic->integrateOverLOS(direction));
+	}
+}
+
 TEST(RotationMeasureIntegrator, PerformanceTest) {
 	auto magfield = std::make_shared<magneticfields::JF12>(
 	    magneticfields::JF12());
@@ -98,6 +115,44 @@ TEST(RotationMeasureIntegrator, PerformanceTest) {
 	EXPECT_LE(pxl_speed, 45);  // ms
 }
 
+TEST(RotationMeasureIntegrator, StaticDispatchPerformanceTest) {
+	auto magfield = std::make_shared<magneticfields::JF12>(
+	    magneticfields::JF12());
+	auto gasdensity = std::make_shared<chargedgas::YMW16>(chargedgas::YMW16());
+	auto dynamic = std::make_shared<RotationMeasureIntegrator>(
+	    RotationMeasureIntegrator(magfield, gasdensity));
+	auto fixed = std::make_shared<RotationMeasureIntegratorJF12YMW16>(
+	    magfield, gasdensity);
+
+	auto skymapDynamic =
+	    std::make_shared<RotationMeasureSkymap>(RotationMeasureSkymap(4));
+	auto skymapFixed =
+	    std::make_shared<RotationMeasureSkymap>(RotationMeasureSkymap(4));
+	skymapDynamic->setIntegrator(dynamic);
+	skymapFixed->setIntegrator(fixed);
+
+	auto start = std::chrono::system_clock::now();
+	skymapDynamic->compute();
+	auto middle = std::chrono::system_clock::now();
+	skymapFixed->compute();
+	auto stop = std::chrono::system_clock::now();
+
+	std::cerr << "virtual: "
+	          << std::chrono::duration<double, std::milli>(middle - start)
+	                 .count()
+	          << " ms, static: "
+	          << std::chrono::duration<double, std::milli>(stop - middle)
+	                 .count()
+	          << " ms" << std::endl;
+
+	// inlining may reorder the floating-point operations (-ffast-math)
+	for (std::size_t ipix = 0; ipix < skymapFixed->size(); ++ipix) {
+		double expected = static_cast<double>(skymapDynamic->getPixel(ipix));
+		EXPECT_NEAR(static_cast<double>(skymapFixed->getPixel(ipix)),
+		            expected, 1e-12 * std::fabs(expected));
+	}
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
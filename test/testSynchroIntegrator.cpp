@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "hermes.h"
+#include "NonSeparableCRDensity.h"
 
 namespace hermes {
 
@@ -129,6 +130,135 @@ TEST(SynchroIntegrator, integrateOverLOS) {
 	// static_cast<double>(T_expected), 1e-9); // K
 }
 
+TEST(SynchroIntegrator, separableModel) {
+	auto mfield = std::make_shared<magneticfields::UniformMagneticField>(
+	    magneticfields::UniformMagneticField(
+	        Vector3QMField(1_muG, -2_muG, 3_muG)));
+	auto wmap = std::make_shared<cosmicrays::WMAP07CRDensity>(
+	    cosmicrays::WMAP07CRDensity(1_GeV, 1e4_GeV, 30));
+	auto sun08 = std::make_shared<cosmicrays::Sun08CRDensity>(
+	    cosmicrays::Sun08CRDensity(1_GeV, 1e4_GeV, 30));
+
+	for (std::shared_ptr<cosmicrays::CosmicRayDensity> model :
+	     {std::static_pointer_cast<cosmicrays::CosmicRayDensity>(wmap),
+	      std::static_pointer_cast<cosmicrays::CosmicRayDensity>(sun08)}) {
+		auto general = std::make_shared<NonSeparableCRDensity>(model);
+		EXPECT_TRUE(model->isSeparable());
+		EXPECT_FALSE(general->isSeparable());
+		// the log-energy sum needs the ratio of the energy axis
+		auto axis = model->getEnergyAxis();
+		EXPECT_TRUE(model->existsScaleFactor());
+		EXPECT_NEAR(model->getEnergyScaleFactor(),
+		            static_cast<double>(axis[1] / axis[0]), 1e-12);
+
+		auto intSeparable = std::make_shared<SynchroIntegrator>(
+		    SynchroIntegrator(mfield, model));
+		auto intGeneral = std::make_shared<SynchroIntegrator>(
+		    SynchroIntegrator(mfield, general));
+
+		for (QFrequency freq : {30_MHz, 1_GHz}) {
+			for (int i = 0; i < 20; ++i) {
+				Vector3QLength pos(1_kpc * (i - 10),
+				                   0.5_kpc * (i % 7) + 0.1_kpc,
+				                   0.2_kpc * (i % 5) - 0.4_kpc);
+				auto expected = intGeneral->integrateOverEnergy(pos, freq);
+				auto emissivity = intSeparable->integrateOverEnergy(pos, freq);
+				EXPECT_NEAR(static_cast<double>(emissivity / expected), 1,
+				            1e-4);
+			}
+		}
+	}
+
+	auto intSeparable = std::make_shared<SynchroIntegrator>(
+	    SynchroIntegrator(mfield, wmap));
+	auto general = std::make_shared<NonSeparableCRDensity>(wmap);
+	auto intGeneral = std::make_shared<SynchroIntegrator>(
+	    SynchroIntegrator(mfield, general));
+
+	// without the table the separable model takes the general path
+	EXPECT_TRUE(intSeparable->isUsingSeparableTable());
+	intSeparable->setUseSeparableTable(false);
+	EXPECT_FALSE(intSeparable->isUsingSeparableTable());
+	for (int i = 0; i < 20; ++i) {
+		Vector3QLength pos(1_kpc * (i - 10), 0.5_kpc * (i % 7) + 0.1_kpc,
+		                   0.2_kpc * (i % 5) - 0.4_kpc);
+		auto expected = intGeneral->integrateOverEnergy(pos, 1_GHz);
+		auto emissivity = intSeparable->integrateOverEnergy(pos, 1_GHz);
+		EXPECT_DOUBLE_EQ(static_cast<double>(emissivity),
+		                 static_cast<double>(expected));
+	}
+}
+
+TEST(SynchroIntegrator, StaticDispatch) {
+	auto mfield = std::make_shared<magneticfields::UniformMagneticField>(
+	    magneticfields::UniformMagneticField(
+	        Vector3QMField(1_muG, -2_muG, 3_muG)));
+	auto wmap = std::make_shared<cosmicrays::WMAP07CRDensity>(
+	    cosmicrays::WMAP07CRDensity(1_GeV, 1e4_GeV, 30));
+	auto general = std::make_shared<NonSeparableCRDensity>(wmap);
+
+	auto dynamic = std::make_shared<SynchroIntegrator>(
+	    SynchroIntegrator(mfield, general));
+	auto fixed = std::make_shared<SynchroIntegratorT<
+	    magneticfields::UniformMagneticField, NonSeparableCRDensity>>(
+	    mfield, general);
+	auto dynamicSeparable = std::make_shared<SynchroIntegrator>(
+	    SynchroIntegrator(mfield, wmap));
+	auto fixedSeparable = std::make_shared<SynchroIntegratorT<
+	    magneticfields::UniformMagneticField, cosmicrays::WMAP07CRDensity>>(
+	    mfield, wmap);
+
+	for (int i = 0; i < 20; ++i) {
+		Vector3QLength pos(1_kpc * (i - 10), 0.5_kpc * (i % 7) + 0.1_kpc,
+		                   0.2_kpc * (i % 5) - 0.4_kpc);
+		EXPECT_EQ(fixed->integrateOverEnergy(pos, 1_GHz),
+		          dynamic->integrateOverEnergy(pos, 1_GHz));
+		EXPECT_EQ(fixedSeparable->integrateOverEnergy(pos, 1_GHz),
+		          dynamicSeparable->integrateOverEnergy(pos, 1_GHz));
+	}
+	QDirection direction = {90_deg, 10_deg};
+	EXPECT_EQ(fixed->integrateOverLOS(direction, 1_GHz),
+	          dynamic->integrateOverLOS(direction, 1_GHz));
+}
+
+TEST(SynchroIntegrator, StaticDispatchJF12) {
+	auto mfield = std::make_shared<magneticfields::JF12>(
+	    magneticfields::JF12());
+	auto wmap = std::make_shared<cosmicrays::WMAP07CRDensity>(
+	    cosmicrays::WMAP07CRDensity(1_GeV, 1e4_GeV, 30));
+	auto dynamic = std::make_shared<SynchroIntegrator>(
+	    SynchroIntegrator(mfield, wmap));
+	auto fixed = std::make_shared<SynchroIntegratorT<
+	    magneticfields::JF12, cosmicrays::WMAP07CRDensity>>(mfield, wmap);
+
+	std::vector<QTemperature> expected, temperatures;
+	auto start = std::chrono::system_clock::now();
+	for (std::size_t ipix = 0; ipix < 192; ipix += 5)
+		expected.push_back(
+		    dynamic->integrateOverLOS(pix2ang_ring(4, ipix), 1_GHz));
+	auto middle = std::chrono::system_clock::now();
+	for (std::size_t ipix = 0; ipix < 192; ipix += 5)
+		temperatures.push_back(
+		    fixed->integrateOverLOS(pix2ang_ring(4, ipix), 1_GHz));
+	auto stop = std::chrono::system_clock::now();
+
+	std::cerr << "virtual: "
+	          << std::chrono::duration<double, std::milli>(middle - start)
+	                 .count()
+	          << " ms, static: "
+	          << std::chrono::duration<double, std::milli>(stop - middle)
+	                 .count()
+	          << " ms" << std::endl;
+
+	// inlining may reorder the floating-point operations (-ffast-math)
+	for (std::size_t i = 0; i < expected.size(); ++i) {
+		EXPECT_GT(static_cast<double>(expected[i]), 0);
+		EXPECT_NEAR(static_cast<double>(temperatures[i]),
+		            static_cast<double>(expected[i]),
+		            1e-12 * static_cast<double>(expected[i]));
+	}
+}
+
 TEST(SynchroIntegrator, PerformanceTest) {
 	auto mfield = std::make_shared<magneticfields::JF12>(
 	    magneticfields::JF12());
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <cmath>
 #include <memory>
 
 #include "gtest/gtest.h"
@@ -43,6 +45,104 @@ TEST(YMW16, compareValues) {
 	            1);
 }
 
+TEST(YMW16, getDensities) {
+	auto gdensity = std::make_shared<chargedgas::YMW16>(chargedgas::YMW16());
+
+	std::vector<Vector3QLength> positions;
+	for (int i = 0; i < 100; ++i)
+		positions.push_back(Vector3QLength(0.2_kpc * (i - 50),
+		                                   0.13_kpc * (i % 30) - 2_kpc,
+		                                   0.03_kpc * (i % 10) - 0.15_kpc));
+
+	std::vector<QPDensity> densities;
+	gdensity->getDensities(positions, densities);
+	ASSERT_EQ(densities.size(), positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+		EXPECT_EQ(densities[i], gdensity->getDensity(positions[i]));
+}
+
+TEST(YMW16, Culling) {
+	chargedgas::YMW16 culled, unculled;
+	EXPECT_TRUE(culled.isCullingEnabled());
+	unculled.disableCulling();
+	EXPECT_FALSE(unculled.isCullingEnabled());
+
+	// ne_ymw16() coordinates in pc; the centre of the Gum nebula, as in
+	// gum(), and directions on a sphere around it
+	const double deg = 3.14159265358979 / 180;
+	const double rgc = 450 * std::cos(-4 * deg);
+	const double xc = rgc * std::sin(264 * deg);
+	const double yc = 8300 - rgc * std::cos(264 * deg);
+	const double zc = 450 * std::sin(-4 * deg);
+	for (double b = -87.5; b < 90; b += 5) {
+		for (double l = 0; l < 360; l += 10) {
+			// from inside the shell (Agn = 125.8 pc, Agn * Kgn = 176 pc) to
+			// beyond the bounding sphere, across the shell edge
+			for (double d = 100; d < 320; d += 1.5) {
+				double x = xc + d * std::cos(b * deg) * std::cos(l * deg);
+				double y = yc + d * std::cos(b * deg) * std::sin(l * deg);
+				double z = zc + d * std::sin(b * deg);
+				int m_culled = 0, m_unculled = 0;
+				EXPECT_EQ(culled.gum(x, y, z, &m_culled),
+				          unculled.gum(x, y, z, &m_unculled));
+			}
+		}
+	}
+
+	// all components, the Galaxy and the local structures
+	Random random;
+	random.seed(39);
+	for (int i = 0; i < 20000; ++i) {
+		Vector3QLength pos(random.randUniform(-20000, 20000),
+		                   random.randUniform(-20000, 20000),
+		                   random.randUniform(-3000, 3000));
+		EXPECT_EQ(culled.ne_ymw16(pos), unculled.ne_ymw16(pos));
+	}
+	for (int i = 0; i < 20000; ++i) {
+		Vector3QLength pos(random.randUniform(-600, 600),
+		                   random.randUniform(7700, 8900),
+		                   random.randUniform(-400, 400));
+		EXPECT_EQ(culled.ne_ymw16(pos), unculled.ne_ymw16(pos));
+	}
+}
+
+TEST(YMW16, BatchPerformanceTest) {
+	chargedgas::YMW16 ymw16;
+
+	// ne_ymw16() coordinates in pc, the Sun at (0, 8300, 6)
+	Random random;
+	random.seed(16);
+	std::vector<Vector3QLength> positions;
+	for (int i = 0; i < 200000; ++i)
+		positions.push_back(Vector3QLength(random.randUniform(-20000, 20000),
+		                                   random.randUniform(-20000, 20000),
+		                                   random.randUniform(-3000, 3000)));
+	// local bubble, Loop I and Gum nebula
+	for (int i = 0; i < 200000; ++i)
+		positions.push_back(Vector3QLength(random.randUniform(-600, 600),
+		                                   random.randUniform(7700, 8900),
+		                                   random.randUniform(-400, 400)));
+
+	auto start = std::chrono::system_clock::now();
+	std::vector<double> scalar(positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+		scalar[i] = ymw16.ne_ymw16(positions[i]);
+	auto mid = std::chrono::system_clock::now();
+	std::vector<double> batch;
+	ymw16.ne_ymw16(positions, batch);
+	auto stop = std::chrono::system_clock::now();
+
+	std::cerr << "YMW16 " << positions.size() << " points, scalar: "
+	          << std::chrono::duration<double, std::milli>(mid - start).count()
+	          << " ms, batch: "
+	          << std::chrono::duration<double, std::milli>(stop - mid).count()
+	          << " ms" << std::endl;
+
+	ASSERT_EQ(batch.size(), positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+		EXPECT_EQ(batch[i], scalar[i]);
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();